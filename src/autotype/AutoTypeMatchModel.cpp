@@ -20,6 +20,7 @@
 
 #include <QFont>
 
+#include "core/Database.h"
 #include "core/DatabaseIcons.h"
 #include "core/Entry.h"
 #include "core/Global.h"
@@ -51,30 +52,79 @@ void AutoTypeMatchModel::setMatchList(const QList<AutoTypeMatch>& matches)
     severConnections();
 
     m_allGroups.clear();
+    m_databases.clear();
     m_matches = matches;
+    connectDatabases(m_matches);
 
-    QSet<Database*> databases;
+    endResetModel();
+}
+
+/**
+ * Change the match list by removing and inserting only the rows that differ.
+ * Matches kept from the current list keep their rows, so views keep their
+ * selection and scroll position.
+ *
+ * @return true if any row was removed or inserted
+ */
+bool AutoTypeMatchModel::updateMatchList(const QList<AutoTypeMatch>& matches)
+{
+    typedef QPair<const Entry*, QString> MatchKey;
 
-    for (AutoTypeMatch& match : m_matches) {
-        databases.insert(match.first->group()->database());
+    QSet<MatchKey> newKeys;
+    newKeys.reserve(matches.size());
+    for (const AutoTypeMatch& match : matches) {
+        newKeys.insert({match.first.data(), match.second});
     }
 
-    for (Database* db : asConst(databases)) {
-        Q_ASSERT(db);
-        for (const Group* group : db->rootGroup()->groupsRecursive(true)) {
-            m_allGroups.append(group);
+    // Remove vanished matches in contiguous ranges, starting from the end to keep the row numbers valid
+    QSet<MatchKey> keptKeys;
+    keptKeys.reserve(m_matches.size());
+    bool changed = false;
+    int row = m_matches.size() - 1;
+    while (row >= 0) {
+        const AutoTypeMatch& match = m_matches.at(row);
+        const MatchKey key(match.first.data(), match.second);
+        if (newKeys.contains(key) && !keptKeys.contains(key)) {
+            keptKeys.insert(key);
+            --row;
+            continue;
         }
 
-        if (db->metadata()->recycleBin()) {
-            m_allGroups.removeOne(db->metadata()->recycleBin());
+        int first = row;
+        while (first > 0) {
+            const AutoTypeMatch& previous = m_matches.at(first - 1);
+            const MatchKey previousKey(previous.first.data(), previous.second);
+            if (newKeys.contains(previousKey) && !keptKeys.contains(previousKey)) {
+                break;
+            }
+            --first;
         }
+
+        beginRemoveRows(QModelIndex(), first, row);
+        m_matches.erase(m_matches.begin() + first, m_matches.begin() + row + 1);
+        endRemoveRows();
+        changed = true;
+        row = first - 1;
     }
 
-    for (const Group* group : asConst(m_allGroups)) {
-        makeConnections(group);
+    QList<AutoTypeMatch> added;
+    for (const AutoTypeMatch& match : matches) {
+        const MatchKey key(match.first.data(), match.second);
+        if (!keptKeys.contains(key)) {
+            keptKeys.insert(key);
+            added.append(match);
+        }
     }
 
-    endResetModel();
+    if (!added.isEmpty()) {
+        connectDatabases(added);
+        beginInsertRows(QModelIndex(), m_matches.size(), m_matches.size() + added.size() - 1);
+        m_matches.append(added);
+        endInsertRows();
+        changed = true;
+    }
+
+    return changed;
 }
 
 int AutoTypeMatchModel::rowCount(const QModelIndex& parent) const
@@ -179,11 +229,56 @@ void AutoTypeMatchModel::entryRemoved()
 {
 }
 
+void AutoTypeMatchModel::entriesAboutToBeTaken(Group* group)
+{
+    QList<AutoTypeMatch> remaining;
+    for (const AutoTypeMatch& match : asConst(m_matches)) {
+        if (match.first->group() != group) {
+            remaining.append(match);
+        }
+    }
+    if (remaining.size() == m_matches.size()) {
+        return;
+    }
+
+    beginResetModel();
+    m_matches = remaining;
+    endResetModel();
+}
+
+void AutoTypeMatchModel::connectDatabases(const QList<AutoTypeMatch>& matches)
+{
+    for (const AutoTypeMatch& match : matches) {
+        const Database* db = match.first->group()->database();
+        Q_ASSERT(db);
+        if (m_databases.contains(db)) {
+            continue;
+        }
+        m_databases.insert(db);
+        // Forget the database when it goes away, so it is neither disconnected later
+        // nor mistaken for a new database created at the same address
+        connect(db, &QObject::destroyed, this, [this, db] { m_databases.remove(db); });
+        // The expired entry style changes without a change of the entry
+        connect(db, SIGNAL(entryExpired(Entry*)), SLOT(entryDataChanged(Entry*)));
+
+        for (const Group* group : db->rootGroup()->groupsRecursive(true)) {
+            if (group != db->metadata()->recycleBin()) {
+                m_allGroups.append(group);
+                makeConnections(group);
+            }
+        }
+    }
+}
+
 void AutoTypeMatchModel::severConnections()
 {
     for (const Group* group : asConst(m_allGroups)) {
         disconnect(group, nullptr, this, nullptr);
     }
+
+    for (const Database* db : asConst(m_databases)) {
+        disconnect(db, nullptr, this, nullptr);
+    }
 }
 
 void AutoTypeMatchModel::makeConnections(const Group* group)
@@ -191,4 +286,5 @@ void AutoTypeMatchModel::makeConnections(const Group* group)
     connect(group, SIGNAL(entryAboutToRemove(Entry*)), SLOT(entryAboutToRemove(Entry*)));
     connect(group, SIGNAL(entryRemoved(Entry*)), SLOT(entryRemoved()));
     connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
+    connect(group, SIGNAL(entriesAboutToBeTaken(Group*)), SLOT(entriesAboutToBeTaken(Group*)));
 }
@@ -20,9 +20,11 @@
 #define KEEPASSX_AUTOTYPEMATCHMODEL_H
 
 #include <QAbstractTableModel>
+#include <QSet>
 
 #include "autotype/AutoTypeMatch.h"
 
+class Database;
 class Entry;
 class Group;
 
@@ -49,18 +51,22 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
     void setMatchList(const QList<AutoTypeMatch>& matches);
+    bool updateMatchList(const QList<AutoTypeMatch>& matches);
 
 private slots:
     void entryAboutToRemove(Entry* entry);
     void entryRemoved();
     void entryDataChanged(Entry* entry);
+    void entriesAboutToBeTaken(Group* group);
 
 private:
     void severConnections();
     void makeConnections(const Group* group);
+    void connectDatabases(const QList<AutoTypeMatch>& matches);
 
     QList<AutoTypeMatch> m_matches;
     QList<const Group*> m_allGroups;
+    QSet<const Database*> m_databases;
 };
 
 #endif // KEEPASSX_AUTOTYPEMATCHMODEL_H
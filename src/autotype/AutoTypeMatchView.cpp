@@ -99,6 +99,40 @@ void AutoTypeMatchView::setMatchList(const QList<AutoTypeMatch>& matches, bool s
     emit currentMatchChanged(currentMatch());
 }
 
+/**
+ * Like setMatchList() but only touches the rows that changed. The current match
+ * stays selected if it is still in the list.
+ */
+void AutoTypeMatchView::updateMatchList(const QList<AutoTypeMatch>& matches, bool selectFirst)
+{
+    const auto previousMatch = currentMatch();
+    const int previousRows = m_model->rowCount();
+
+    const bool changed = m_model->updateMatchList(matches);
+    if (!m_sortModel->filterRegExp().isEmpty()) {
+        m_sortModel->setFilterWildcard({});
+    }
+
+    if (m_model->rowCount() > previousRows) {
+        horizontalHeader()->resizeSections(QHeaderView::ResizeToContents);
+    }
+
+    if (previousMatch.first && matches.contains(previousMatch)) {
+        if (!changed) {
+            return;
+        }
+        selectionModel()->setCurrentIndex(m_sortModel->mapFromSource(m_model->indexFromMatch(previousMatch)),
+                                          QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    } else if (selectFirst) {
+        selectionModel()->setCurrentIndex(m_sortModel->index(0, 0),
+                                          QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    } else {
+        selectionModel()->clear();
+    }
+
+    emit currentMatchChanged(currentMatch());
+}
+
 void AutoTypeMatchView::filterList(const QString& filter)
 {
     m_sortModel->setFilterWildcard(filter);
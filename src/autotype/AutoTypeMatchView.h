@@ -35,6 +35,7 @@ public:
     AutoTypeMatch currentMatch();
     AutoTypeMatch matchFromIndex(const QModelIndex& index);
     void setMatchList(const QList<AutoTypeMatch>& matches, bool selectFirst);
+    void updateMatchList(const QList<AutoTypeMatch>& matches, bool selectFirst);
     void filterList(const QString& filter);
     void moveSelection(int offset);
 
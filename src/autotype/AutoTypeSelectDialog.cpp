@@ -21,6 +21,7 @@
 
 #include <QCloseEvent>
 #include <QMenu>
+#include <QRegularExpression>
 #include <QShortcut>
 #if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
 #include <QScreen>
@@ -32,6 +33,7 @@
 #include "core/Database.h"
 #include "core/Entry.h"
 #include "core/EntrySearcher.h"
+#include "core/Global.h"
 #include "gui/Clipboard.h"
 #include "gui/Icons.h"
 
@@ -95,8 +97,34 @@ AutoTypeSelectDialog::~AutoTypeSelectDialog()
 
 void AutoTypeSelectDialog::setMatches(const QList<AutoTypeMatch>& matches, const QList<QSharedPointer<Database>>& dbs)
 {
+    for (const auto& db : asConst(m_dbs)) {
+        db->disconnect(this);
+    }
+
     m_matches = matches;
     m_dbs = dbs;
+    m_sequenceCache.clear();
+    invalidateSearchResults();
+
+    for (const auto& db : asConst(m_dbs)) {
+        connect(db.data(), &Database::entryAdded, this, [this](Entry* entry) {
+            // Moved entries inherit the sequence of their new group
+            m_sequenceCache.remove(entry);
+            invalidateSearchResults();
+        });
+        connect(db.data(), &Database::entryDataChanged, this, [this](Entry* entry) {
+            m_sequenceCache.remove(entry);
+            invalidateSearchResults();
+        });
+        // Window associations and the entry's own sequence only emit modified
+        connect(db.data(), &Database::entryModified, this, [this](Entry* entry) { m_sequenceCache.remove(entry); });
+        // Group sequences are inherited by every entry below the group
+        connect(db.data(), &Database::groupDataChanged, this, [this] { m_sequenceCache.clear(); });
+        connect(db.data(), &Database::entryAboutToRemove, this, [this](Entry* entry) {
+            m_sequenceCache.remove(entry);
+            m_searchResults.removeOne(entry);
+        });
+    }
 
     m_ui->view->setMatchList(m_matches, !m_matches.isEmpty() || !m_ui->search->text().isEmpty());
     m_ui->searchCheckBox->setChecked(m_matches.isEmpty());
@@ -118,33 +146,68 @@ void AutoTypeSelectDialog::performSearch()
         return;
     }
 
-    auto searchText = m_ui->search->text();
-    // If no search text, find all entries
-    if (searchText.isEmpty()) {
-        searchText.append("*");
+    const auto text = m_ui->search->text();
+    if (!m_searchResultsValid || text != m_lastSearchText) {
+        EntrySearcher searcher;
+        if (m_searchResultsValid && canNarrowSearch(m_lastSearchText, text)) {
+            m_searchResults = searcher.searchEntries(text, m_searchResults);
+        } else {
+            m_searchResults.clear();
+            for (const auto& db : asConst(m_dbs)) {
+                // If no search text, find all entries
+                m_searchResults.append(searcher.search(text.isEmpty() ? QStringLiteral("*") : text, db->rootGroup()));
+            }
+        }
+        m_lastSearchText = text;
+        m_searchResultsValid = true;
     }
 
-    EntrySearcher searcher;
     QList<AutoTypeMatch> matches;
-    for (const auto& db : m_dbs) {
-        auto found = searcher.search(searchText, db->rootGroup());
-        for (auto* entry : found) {
-            QSet<QString> sequences;
-            auto defSequence = entry->effectiveAutoTypeSequence();
-            if (!defSequence.isEmpty()) {
-                matches.append({entry, defSequence});
-                sequences << defSequence;
-            }
-            for (const auto& assoc : entry->autoTypeAssociations()->getAll()) {
-                if (!sequences.contains(assoc.sequence) && !assoc.sequence.isEmpty()) {
-                    matches.append({entry, assoc.sequence});
-                    sequences << assoc.sequence;
-                }
+    for (auto* entry : asConst(m_searchResults)) {
+        for (const auto& sequence : sequencesFor(entry)) {
+            matches.append({entry, sequence});
+        }
+    }
+
+    m_ui->view->updateMatchList(matches, !text.isEmpty());
+}
+
+/**
+ * Appending plain words to a query can only remove results, so the new query
+ * only has to be checked against the previous results. Modifiers, wildcards,
+ * quotes and field prefixes can widen the result set and force a full search.
+ */
+bool AutoTypeSelectDialog::canNarrowSearch(const QString& previousText, const QString& searchText)
+{
+    static const QRegularExpression specialCharacters(R"([-!*+?|:"\\])");
+    return searchText.startsWith(previousText) && !searchText.contains(specialCharacters);
+}
+
+/**
+ * @return the default sequence and the distinct window association sequences of an entry
+ */
+const QStringList& AutoTypeSelectDialog::sequencesFor(Entry* entry)
+{
+    auto it = m_sequenceCache.find(entry);
+    if (it == m_sequenceCache.end()) {
+        QStringList sequences;
+        auto defSequence = entry->effectiveAutoTypeSequence();
+        if (!defSequence.isEmpty()) {
+            sequences << defSequence;
+        }
+        for (const auto& assoc : entry->autoTypeAssociations()->getAll()) {
+            if (!sequences.contains(assoc.sequence) && !assoc.sequence.isEmpty()) {
+                sequences << assoc.sequence;
             }
         }
+        it = m_sequenceCache.insert(entry, sequences);
     }
+    return it.value();
+}
 
-    m_ui->view->setMatchList(matches, !m_ui->search->text().isEmpty());
+void AutoTypeSelectDialog::invalidateSearchResults()
+{
+    m_searchResultsValid = false;
 }
 
 void AutoTypeSelectDialog::activateCurrentMatch()
@@ -21,9 +21,11 @@
 
 #include "autotype/AutoTypeMatch.h"
 #include <QDialog>
+#include <QHash>
 #include <QTimer>
 
 class Database;
+class Entry;
 class QMenu;
 
 namespace Ui
@@ -41,6 +43,8 @@ public:
 
     void setMatches(const QList<AutoTypeMatch>& matchList, const QList<QSharedPointer<Database>>& dbs);
 
+    static bool canNarrowSearch(const QString& previousText, const QString& searchText);
+
 signals:
     void matchActivated(AutoTypeMatch match);
 
@@ -57,6 +61,8 @@ private slots:
 
 private:
     void buildActionMenu();
+    const QStringList& sequencesFor(Entry* entry);
+    void invalidateSearchResults();
 
     QScopedPointer<Ui::AutoTypeSelectDialog> m_ui;
 
@@ -65,6 +71,12 @@ private:
     QTimer m_searchTimer;
     QPointer<QMenu> m_actionMenu;
 
+    // Results of the last search, a longer query only searches within them
+    QString m_lastSearchText;
+    QList<Entry*> m_searchResults;
+    bool m_searchResultsValid = false;
+    QHash<const Entry*, QStringList> m_sequenceCache;
+
     bool m_accepted = false;
 };
 
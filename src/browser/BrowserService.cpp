@@ -38,6 +38,7 @@
 #include "core/Metadata.h"
 #include "core/PasswordGenerator.h"
 #include "core/Tools.h"
+#include "core/Tracing.h"
 #include "gui/MainWindow.h"
 #include "gui/MessageBox.h"
 #ifdef Q_OS_MACOS
@@ -383,6 +384,7 @@ QJsonArray BrowserService::findMatchingEntries(const QString& dbid,
                                                const bool httpAuth)
 {
     Q_UNUSED(dbid);
+    Tracing::Span span("BrowserService::findMatchingEntries", "browser");
     const bool alwaysAllowAccess = browserSettings()->alwaysAllowAccess();
     const bool ignoreHttpAuth = browserSettings()->httpAuthPermission();
     const QString siteHost = QUrl(siteUrlStr).host();
@@ -456,6 +458,7 @@ QJsonArray BrowserService::findMatchingEntries(const QString& dbid,
         result.append(prepareEntry(entry));
     }
 
+    span.setArg("results", result.size());
     return result;
 }
 
@@ -1056,7 +1059,7 @@ bool BrowserService::handleURL(const QString& entryUrl, const QString& siteUrlSt
     }
 
     // Check for illegal characters
-    QRegularExpression re("[<>\\^`{|}]");
+    static const QRegularExpression re("[<>\\^`{|}]");
     if (re.match(entryUrl).hasMatch()) {
         return false;
     }
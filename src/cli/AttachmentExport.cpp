@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AttachmentExport.h"
+
+#include "Utils.h"
+#include "core/EntryAttachments.h"
+#include "core/Group.h"
+
+#include <QFile>
+
+const QCommandLineOption AttachmentExport::StdoutOption =
+    QCommandLineOption(QStringList() << "stdout", QObject::tr("Write the attachment to stdout instead of a file."));
+
+AttachmentExport::AttachmentExport()
+{
+    name = QString("attachment-export");
+    description = QObject::tr("Export an attachment of an entry.");
+    options.append(AttachmentExport::StdoutOption);
+    positionalArguments.append({QString("entry"), QObject::tr("Path of the entry."), QString("")});
+    positionalArguments.append(
+        {QString("attachment-name"), QObject::tr("Name of the attachment to export."), QString("")});
+    optionalArguments.append({QString("export-file"),
+                              QObject::tr("Path of the file to export the attachment to, unless --stdout is set."),
+                              QString("[export-file]")});
+}
+
+int AttachmentExport::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
+{
+    auto& out = parser->isSet(Command::QuietOption) ? Utils::DEVNULL : Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    const QStringList args = parser->positionalArguments();
+    const QString& entryPath = args.at(1);
+    const QString& attachmentName = args.at(2);
+    const QString exportPath = args.value(3);
+    if (exportPath.isEmpty() && !parser->isSet(AttachmentExport::StdoutOption)) {
+        err << QObject::tr("No export file specified, use --stdout to write the attachment to stdout.") << endl;
+        return EXIT_FAILURE;
+    }
+
+    Entry* entry = database->rootGroup()->findEntryByPath(entryPath);
+    if (!entry) {
+        err << QObject::tr("Could not find entry with path %1.").arg(entryPath) << endl;
+        return EXIT_FAILURE;
+    }
+
+    const EntryAttachments* attachments = entry->attachments();
+    if (!attachments->hasKey(attachmentName)) {
+        err << QObject::tr("Could not find attachment with name %1.").arg(attachmentName) << endl;
+        return EXIT_FAILURE;
+    }
+
+    QString errorMessage;
+    if (parser->isSet(AttachmentExport::StdoutOption)) {
+        // Bypass the text stream, the attachment is written as it is
+        Utils::STDOUT.flush();
+        if (!attachments->exportAttachment(attachmentName, Utils::STDOUT.device(), &errorMessage)) {
+            err << QObject::tr("Could not write attachment %1: %2").arg(attachmentName, errorMessage) << endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    QFile exportFile(exportPath);
+    if (!exportFile.open(QIODevice::WriteOnly)) {
+        err << QObject::tr("Could not open output file %1: %2").arg(exportPath, exportFile.errorString()) << endl;
+        return EXIT_FAILURE;
+    }
+    if (!attachments->exportAttachment(attachmentName, &exportFile, &errorMessage)) {
+        exportFile.remove();
+        err << QObject::tr("Could not write attachment %1: %2").arg(attachmentName, errorMessage) << endl;
+        return EXIT_FAILURE;
+    }
+
+    out << QObject::tr("Successfully exported attachment %1 of entry %2 to %3.")
+               .arg(attachmentName, entryPath, exportPath)
+        << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -20,6 +20,8 @@
 #include "Add.h"
 #include "AddGroup.h"
 #include "Analyze.h"
+#include "AttachmentExport.h"
+#include "AttachmentImport.h"
 #include "Clip.h"
 #include "Close.h"
 #include "Create.h"
@@ -108,7 +110,7 @@ QString Command::getDescriptionLine()
 {
     QString response = name;
     QString space(" ");
-    QString spaces = space.repeated(15 - name.length());
+    QString spaces = space.repeated(20 - name.length());
     response = response.append(spaces);
     response = response.append(description);
     response = response.append("\n");
@@ -163,6 +165,8 @@ namespace Commands
 
         s_commands.insert(QStringLiteral("add"), QSharedPointer<Command>(new Add()));
         s_commands.insert(QStringLiteral("analyze"), QSharedPointer<Command>(new Analyze()));
+        s_commands.insert(QStringLiteral("attachment-export"), QSharedPointer<Command>(new AttachmentExport()));
+        s_commands.insert(QStringLiteral("attachment-import"), QSharedPointer<Command>(new AttachmentImport()));
         s_commands.insert(QStringLiteral("clip"), QSharedPointer<Command>(new Clip()));
         s_commands.insert(QStringLiteral("close"), QSharedPointer<Command>(new Close()));
         s_commands.insert(QStringLiteral("db-create"), QSharedPointer<Command>(new Create()));
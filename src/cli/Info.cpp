@@ -18,16 +18,24 @@
 #include "Info.h"
 
 #include "Utils.h"
+#include "core/DatabaseStatistics.h"
 #include "core/Global.h"
 #include "core/Metadata.h"
+#include "core/Tools.h"
+
+const QCommandLineOption Info::MemoryOption =
+    QCommandLineOption(QStringList() << "m"
+                                     << "memory",
+                       QObject::tr("Show the approximate memory usage of the database content."));
 
 Info::Info()
 {
     name = QString("db-info");
     description = QObject::tr("Show a database's information.");
+    options.append(Info::MemoryOption);
 }
 
-int Info::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser>)
+int Info::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
 {
     auto& out = Utils::STDOUT;
 
@@ -45,5 +53,26 @@ int Info::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
     } else {
         out << QObject::tr("Recycle bin is not enabled.") << endl;
     }
+
+    auto* stats = database->statistics();
+    out << QObject::tr("Number of groups: ") << stats->groupCount() << endl;
+    out << QObject::tr("Number of entries: ") << stats->entryCount() << endl;
+    out << QObject::tr("Number of expired entries: ") << stats->expiredEntries() << endl;
+    out << QObject::tr("Size of entries: ") << Tools::humanReadableFileSize(stats->entriesSize()) << endl;
+    out << QObject::tr("Size of history: ") << Tools::humanReadableFileSize(stats->historySize()) << endl;
+
+    if (parser->isSet(Info::MemoryOption)) {
+        const auto usage = stats->memoryUsage();
+        out << QObject::tr("Memory usage (approximate):") << endl;
+        out << "  " << QObject::tr("Entries: ") << Tools::humanReadableFileSize(usage.entries) << endl;
+        out << "  " << QObject::tr("History: ") << Tools::humanReadableFileSize(usage.history) << endl;
+        out << "  " << QObject::tr("Attachments: ") << Tools::humanReadableFileSize(usage.attachments) << endl;
+        out << "  " << QObject::tr("Icons: ") << Tools::humanReadableFileSize(usage.icons) << endl;
+        out << "  " << QObject::tr("Custom data: ") << Tools::humanReadableFileSize(usage.customData) << endl;
+        out << "  " << QObject::tr("Groups: ") << Tools::humanReadableFileSize(usage.groups) << endl;
+        out << "  " << QObject::tr("Deleted objects: ") << Tools::humanReadableFileSize(usage.deletedObjects)
+            << endl;
+        out << "  " << QObject::tr("Total: ") << Tools::humanReadableFileSize(usage.total()) << endl;
+    }
     return EXIT_SUCCESS;
 }
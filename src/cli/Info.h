@@ -26,6 +26,8 @@ public:
     Info();
 
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser);
+
+    static const QCommandLineOption MemoryOption;
 };
 
 #endif // KEEPASSXC_INFO_H
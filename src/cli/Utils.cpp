@@ -371,6 +371,28 @@ namespace Utils
         return result;
     }
 
+    /**
+     * Remove the first occurrence of an option that takes a value, given
+     * either as "--name value" or as "--name=value".
+     * Used for global options that the sub-commands do not know.
+     */
+    QStringList removeOptionWithValue(const QStringList& arguments, const QString& name)
+    {
+        QStringList result = arguments;
+        const QString option = "--" + name;
+        for (int i = 0; i < result.size(); ++i) {
+            if (result[i] == option) {
+                result.erase(result.begin() + i, result.begin() + qMin(i + 2, result.size()));
+                break;
+            }
+            if (result[i].startsWith(option + "=")) {
+                result.removeAt(i);
+                break;
+            }
+        }
+        return result;
+    }
+
     QStringList findAttributes(const EntryAttributes& attributes, const QString& name)
     {
         QStringList result;
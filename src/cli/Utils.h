@@ -47,6 +47,7 @@ namespace Utils
                                             bool quiet = false);
 
     QStringList splitCommandString(const QString& command);
+    QStringList removeOptionWithValue(const QStringList& arguments, const QString& name);
 
     /**
      * If `attributes` contains an attribute named `name` (case-sensitive),
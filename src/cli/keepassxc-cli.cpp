@@ -28,6 +28,7 @@
 #include "core/Bootstrap.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
+#include "core/Tracing.h"
 #include "crypto/Crypto.h"
 
 #if defined(WITH_ASAN) && defined(WITH_LSAN)
@@ -203,6 +204,10 @@ int main(int argc, char** argv)
 
     QCommandLineOption debugInfoOption(QStringList() << "debug-info", QObject::tr("Displays debugging information."));
     parser.addOption(debugInfoOption);
+    QCommandLineOption traceOption(QStringList() << "trace",
+                                   QObject::tr("Write timing information to the given Chrome trace file on exit."),
+                                   QObject::tr("file"));
+    parser.addOption(traceOption);
     parser.addHelpOption();
     parser.addVersionOption();
     // TODO : use the setOptionsAfterPositionalArgumentsMode (Qt 5.6) function
@@ -224,6 +229,12 @@ int main(int argc, char** argv)
         parser.showHelp();
     }
 
+    if (parser.isSet(traceOption)) {
+        Tracing::start(parser.value(traceOption));
+        // The sub-command parses the remaining arguments, so drop the global option
+        arguments = Utils::removeOptionWithValue(arguments, "trace");
+    }
+
     QString commandName = parser.positionalArguments().at(0);
     if (commandName == "open") {
         enterInteractiveMode(arguments);
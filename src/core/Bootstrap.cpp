@@ -18,6 +18,7 @@
 #include "Bootstrap.h"
 #include "config-keepassx.h"
 #include "core/Config.h"
+#include "core/Tracing.h"
 #include "core/Translator.h"
 
 #ifdef Q_OS_WIN
@@ -72,6 +73,7 @@ namespace Bootstrap
 
         setupSearchPaths();
         applyEarlyQNetworkAccessManagerWorkaround();
+        Tracing::startFromEnvironment();
 
         Translator::installTranslators();
     }
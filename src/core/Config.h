@@ -43,6 +43,7 @@ public:
         AutoReloadOnChange,
         AutoSaveOnExit,
         AutoSaveNonDataChanges,
+        AutoSaveUseJournal,
         BackupBeforeSave,
         UseAtomicSaves,
         SearchLimitGroup,
@@ -117,6 +118,7 @@ public:
         Security_HidePasswordPreviewPanel,
         Security_AutoTypeAsk,
         Security_IconDownloadFallback,
+        Security_IconDownloadCache,
         Security_ResetTouchId,
         Security_ResetTouchIdTimeout,
         Security_ResetTouchIdScreenlock,
@@ -25,6 +25,7 @@ const QString CustomData::Created = QStringLiteral("_CREATED");
 const QString CustomData::BrowserKeyPrefix = QStringLiteral("KPXC_BROWSER_");
 const QString CustomData::BrowserLegacyKeyPrefix = QStringLiteral("Public Key: ");
 const QString CustomData::ExcludeFromReports = QStringLiteral("KnownBad");
+const QString CustomData::DeletedObjectsMaxAge = QStringLiteral("KPXC_DELETED_OBJECTS_MAX_AGE");
 
 CustomData::CustomData(QObject* parent)
     : ModifiableObject(parent)
@@ -67,6 +68,7 @@ void CustomData::set(const QString& key, const QString& value)
 
     if (addAttribute || changeValue) {
         m_data.insert(key, value);
+        m_dataSize = -1;
         updateLastModified();
         emitModified();
     }
@@ -81,6 +83,7 @@ void CustomData::remove(const QString& key)
     emit aboutToBeRemoved(key);
 
     m_data.remove(key);
+    m_dataSize = -1;
 
     updateLastModified();
     emit removed(key);
@@ -102,6 +105,7 @@ void CustomData::rename(const QString& oldKey, const QString& newKey)
 
     m_data.remove(oldKey);
     m_data.insert(newKey, data);
+    m_dataSize = -1;
 
     updateLastModified();
     emitModified();
@@ -117,6 +121,7 @@ void CustomData::copyDataFrom(const CustomData* other)
     emit aboutToBeReset();
 
     m_data = other->m_data;
+    m_dataSize = -1;
 
     updateLastModified();
     emit reset();
@@ -151,6 +156,7 @@ void CustomData::clear()
     emit aboutToBeReset();
 
     m_data.clear();
+    m_dataSize = -1;
 
     emit reset();
     emitModified();
@@ -168,18 +174,23 @@ int CustomData::size() const
 
 int CustomData::dataSize() const
 {
-    int size = 0;
+    // The size is cached until the data changes
+    if (m_dataSize < 0) {
+        int size = 0;
 
-    QHashIterator<QString, QString> i(m_data);
-    while (i.hasNext()) {
-        i.next();
-        size += i.key().toUtf8().size() + i.value().toUtf8().size();
+        QHashIterator<QString, QString> i(m_data);
+        while (i.hasNext()) {
+            i.next();
+            size += i.key().toUtf8().size() + i.value().toUtf8().size();
+        }
+        m_dataSize = size;
     }
-    return size;
+    return m_dataSize;
 }
 
 void CustomData::updateLastModified()
 {
+    m_dataSize = -1;
     if (m_data.size() == 1 && m_data.contains(LastModified)) {
         m_data.remove(LastModified);
         return;
@@ -54,6 +54,7 @@ public:
     static const QString BrowserKeyPrefix;
     static const QString BrowserLegacyKeyPrefix;
     static const QString ExcludeFromReports;
+    static const QString DeletedObjectsMaxAge;
 
 signals:
     void aboutToBeAdded(const QString& key);
@@ -70,6 +71,7 @@ private slots:
 
 private:
     QHash<QString, QString> m_data;
+    mutable int m_dataSize = -1;
 };
 
 #endif // KEEPASSXC_CUSTOMDATA_H
@@ -20,10 +20,17 @@
 
 #include "core/AsyncTask.h"
 #include "core/Clock.h"
+#include "core/CustomData.h"
+#include "core/DatabaseJournal.h"
+#include "core/DatabaseStatistics.h"
+#include "core/ExpiryScheduler.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
 #include "core/Merger.h"
 #include "core/Metadata.h"
+#include "core/TagIndex.h"
+#include "core/Tracing.h"
+#include "core/UsernameStatistics.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
@@ -44,6 +51,11 @@ Database::Database()
     , m_data()
     , m_rootGroup(nullptr)
     , m_fileWatcher(new FileWatcher(this))
+    , m_journal(new DatabaseJournal(this))
+    , m_usernameStatistics(new UsernameStatistics())
+    , m_statistics(new DatabaseStatistics(this))
+    , m_tagIndex(new TagIndex())
+    , m_expiryScheduler(new ExpiryScheduler())
     , m_uuid(QUuid::createUuid())
 {
     // setup modified timer
@@ -57,8 +69,50 @@ Database::Database()
 
     // other signals
     connect(m_metadata, &Metadata::modified, this, &Database::markAsModified);
-    connect(this, &Database::databaseOpened, this, [this]() { updateCommonUsernames(); });
-    connect(this, &Database::databaseSaved, this, [this]() { updateCommonUsernames(); });
+    connect(m_metadata, &Metadata::modified, this, [this]() { m_journal->requireFullSave(); });
+    connect(this, &Database::groupAboutToAdd, this, [this](Group* group) {
+        // Groups and entries added as a whole tree only signal a change of the top group
+        for (const Group* child : group->groupsRecursive(true)) {
+            m_journal->markGroupChanged(child);
+            for (const Entry* entry : child->entries()) {
+                m_journal->markEntryChanged(entry);
+            }
+        }
+    });
+    connect(this, &Database::entryAdded, this, [this](Entry* entry) {
+        m_journal->markEntryChanged(entry);
+        m_entryIndex.insert(entry->uuid(), entry);
+        m_usernameStatistics->addEntry(entry);
+        m_statistics->addEntry(entry);
+        m_tagIndex->addEntry(entry);
+        m_expiryScheduler->addEntry(entry);
+    });
+    connect(this, &Database::entryAboutToRemove, this, [this](Entry* entry) {
+        if (m_entryIndex.value(entry->uuid()) == entry) {
+            m_entryIndex.remove(entry->uuid());
+        }
+        m_usernameStatistics->removeEntry(entry);
+        m_statistics->removeEntry(entry);
+        m_tagIndex->removeEntry(entry);
+        m_expiryScheduler->removeEntry(entry);
+    });
+    connect(this, &Database::entryDataChanged, this, [this](Entry* entry) {
+        m_usernameStatistics->updateEntry(entry);
+        m_statistics->updateEntry(entry);
+        m_tagIndex->updateEntry(entry);
+        m_expiryScheduler->updateEntry(entry);
+    });
+    connect(this, &Database::entryModified, this, [this](Entry* entry) {
+        m_statistics->updateEntry(entry);
+        m_tagIndex->updateEntry(entry);
+        m_expiryScheduler->updateEntry(entry);
+    });
+    connect(m_expiryScheduler.data(), &ExpiryScheduler::entryExpired, this, &Database::entryExpired);
+    connect(this, &Database::groupAdded, this, [this]() { m_statistics->invalidate(); });
+    connect(this, &Database::groupRemoved, this, [this]() { m_statistics->invalidate(); });
+    connect(this, &Database::groupChildrenTaken, this, [this]() { m_statistics->invalidate(); });
+    connect(this, &Database::groupMoved, this, [this]() { m_statistics->invalidate(); });
+    connect(m_metadata, &Metadata::modified, this, [this]() { m_statistics->invalidate(); });
     connect(m_fileWatcher, &FileWatcher::fileChanged, this, &Database::databaseFileChanged);
 
     // static uuid map
@@ -123,6 +177,7 @@ bool Database::open(QSharedPointer<const CompositeKey> key, QString* error, bool
  */
 bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey> key, QString* error, bool readOnly)
 {
+    Tracing::Span span("Database::open");
     QFile dbFile(filePath);
     if (!dbFile.exists()) {
         if (error) {
@@ -146,6 +201,7 @@ bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey>
     }
 
     setEmitModified(false);
+    span.setArg("size", dbFile.size());
 
     KeePass2Reader reader;
     if (!reader.readDatabase(&dbFile, std::move(key), this)) {
@@ -159,7 +215,17 @@ bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey>
     setFilePath(filePath);
     dbFile.close();
 
+    // Apply changes that were journaled but not yet saved into the database file
+    QString journalError;
+    int journalRecords = m_journal->replay(&journalError);
+    if (!journalError.isEmpty()) {
+        qWarning("Database journal: %s", qPrintable(journalError));
+    }
+
     markAsClean();
+    if (journalRecords > 0) {
+        m_modified = true;
+    }
 
     emit databaseOpened();
     m_fileWatcher->start(canonicalFilePath(), 30, 1);
@@ -219,6 +285,7 @@ bool Database::save(QString* error, bool atomic, bool backup)
  */
 bool Database::saveAs(const QString& filePath, QString* error, bool atomic, bool backup)
 {
+    Tracing::Span span("Database::saveAs");
     // Disallow overlapping save operations
     if (isSaving()) {
         if (error) {
@@ -262,6 +329,8 @@ bool Database::saveAs(const QString& filePath, QString* error, bool atomic, bool
     setReadOnly(false);
     m_fileWatcher->stop();
 
+    pruneDeletedObjects();
+
     QFileInfo fileInfo(filePath);
     auto realFilePath = fileInfo.exists() ? fileInfo.canonicalFilePath() : fileInfo.absoluteFilePath();
     bool isNewFile = !QFile::exists(realFilePath);
@@ -269,6 +338,7 @@ bool Database::saveAs(const QString& filePath, QString* error, bool atomic, bool
     if (ok) {
         markAsClean();
         setFilePath(filePath);
+        m_journal->checkpoint(true);
         if (isNewFile) {
             QFile::setPermissions(realFilePath, QFile::ReadUser | QFile::WriteUser);
         }
@@ -404,6 +474,37 @@ bool Database::writeDatabase(QIODevice* device, QString* error)
     return true;
 }
 
+/**
+ * Durably record the changes made since the last save or journal append
+ * in the journal next to the database file, without rewriting the file.
+ *
+ * @param error error message in case of failure
+ * @return true on success, false if a full save is required
+ */
+bool Database::appendToJournal(QString* error)
+{
+    if (m_data.isReadOnly || isSaving()) {
+        return false;
+    }
+    return m_journal->append(error);
+}
+
+/**
+ * Remove the journal of changes that are not going to be saved.
+ */
+void Database::discardJournal()
+{
+    m_journal->discard();
+}
+
+/**
+ * @return size of the journal file in bytes
+ */
+qint64 Database::journalSize() const
+{
+    return m_journal->size();
+}
+
 bool Database::extract(QByteArray& xmlOutput, QString* error)
 {
     KeePass2Writer writer;
@@ -471,7 +572,7 @@ void Database::releaseData()
     m_fileWatcher->stop();
 
     m_deletedObjects.clear();
-    m_commonUsernames.clear();
+    m_deletedObjectIndex.clear();
 }
 
 /**
@@ -628,22 +729,12 @@ const QList<DeletedObject>& Database::deletedObjects() const
 
 bool Database::containsDeletedObject(const QUuid& uuid) const
 {
-    for (const DeletedObject& currentObject : m_deletedObjects) {
-        if (currentObject.uuid == uuid) {
-            return true;
-        }
-    }
-    return false;
+    return m_deletedObjectIndex.contains(uuid);
 }
 
 bool Database::containsDeletedObject(const DeletedObject& object) const
 {
-    for (const DeletedObject& currentObject : m_deletedObjects) {
-        if (currentObject.uuid == object.uuid) {
-            return true;
-        }
-    }
-    return false;
+    return m_deletedObjectIndex.contains(object.uuid);
 }
 
 void Database::setDeletedObjects(const QList<DeletedObject>& delObjs)
@@ -651,12 +742,33 @@ void Database::setDeletedObjects(const QList<DeletedObject>& delObjs)
     if (m_deletedObjects == delObjs) {
         return;
     }
-    m_deletedObjects = delObjs;
+    m_deletedObjects.clear();
+    m_deletedObjectIndex.clear();
+    for (const DeletedObject& delObj : delObjs) {
+        addDeletedObject(delObj);
+    }
 }
 
+/**
+ * Add a deletion record. Each uuid is only recorded once, keeping the
+ * earliest deletion time. Merger::mergeDeletions() reduces duplicate records
+ * to the earliest time as well, so merges behave as if every record was kept.
+ * It also means that Merger::eraseEntry() cannot move an existing record
+ * forward, dropping the records it adds is enough to undo an erase.
+ */
 void Database::addDeletedObject(const DeletedObject& delObj)
 {
     Q_ASSERT(delObj.deletionTime.timeSpec() == Qt::UTC);
+    m_journal->markDeleted(delObj.uuid);
+    auto it = m_deletedObjectIndex.constFind(delObj.uuid);
+    if (it != m_deletedObjectIndex.constEnd()) {
+        DeletedObject& existing = m_deletedObjects[it.value()];
+        if (delObj.deletionTime < existing.deletionTime) {
+            existing.deletionTime = delObj.deletionTime;
+        }
+        return;
+    }
+    m_deletedObjectIndex.insert(delObj.uuid, m_deletedObjects.size());
     m_deletedObjects.append(delObj);
 }
 
@@ -669,15 +781,164 @@ void Database::addDeletedObject(const QUuid& uuid)
     addDeletedObject(delObj);
 }
 
-QList<QString> Database::commonUsernames()
+/**
+ * Drop the most recent deletion records, keeping the first count records
+ *
+ * @param count number of records to keep
+ */
+void Database::truncateDeletedObjects(int count)
+{
+    while (m_deletedObjects.size() > count) {
+        m_deletedObjectIndex.remove(m_deletedObjects.takeLast().uuid);
+    }
+}
+
+/**
+ * @return maximum age in days of deletion records kept on save, 0 if they are kept forever
+ */
+int Database::deletedObjectsMaxAge() const
+{
+    return qMax(0, m_metadata->customData()->value(CustomData::DeletedObjectsMaxAge).toInt());
+}
+
+void Database::setDeletedObjectsMaxAge(int days)
+{
+    if (days > 0) {
+        m_metadata->customData()->set(CustomData::DeletedObjectsMaxAge, QString::number(days));
+    } else {
+        m_metadata->customData()->remove(CustomData::DeletedObjectsMaxAge);
+    }
+}
+
+/**
+ * Remove deletion records older than the configured maximum age.
+ *
+ * Replicas that have not been synchronized within that time may
+ * bring pruned objects back on the next merge.
+ *
+ * @return number of removed records
+ */
+int Database::pruneDeletedObjects()
+{
+    const int maxAge = deletedObjectsMaxAge();
+    if (maxAge <= 0 || m_deletedObjects.isEmpty()) {
+        return 0;
+    }
+
+    const QDateTime cutoff = Clock::currentDateTimeUtc().addDays(-maxAge);
+    QList<DeletedObject> kept;
+    kept.reserve(m_deletedObjects.size());
+    for (const DeletedObject& delObj : asConst(m_deletedObjects)) {
+        if (delObj.deletionTime >= cutoff) {
+            kept.append(delObj);
+        }
+    }
+
+    const int removed = m_deletedObjects.size() - kept.size();
+    if (removed > 0) {
+        setDeletedObjects(kept);
+    }
+    return removed;
+}
+
+/**
+ * Collapse custom icons showing the same picture into one icon.
+ *
+ * Entries, their history items and groups using a duplicate are switched
+ * to the remaining icon without touching their modification times.
+ *
+ * @return number of removed icons
+ */
+int Database::mergeDuplicateCustomIcons()
+{
+    const QHash<QUuid, QUuid> duplicates = m_metadata->duplicateCustomIcons();
+    if (duplicates.isEmpty()) {
+        return 0;
+    }
+
+    const QList<Entry*> entries = m_rootGroup->entriesRecursive(true);
+    for (Entry* entry : entries) {
+        const QUuid replacement = duplicates.value(entry->iconUuid());
+        if (!replacement.isNull()) {
+            const bool updateTimeinfo = entry->canUpdateTimeinfo();
+            entry->setUpdateTimeinfo(false);
+            entry->setIcon(replacement);
+            entry->setUpdateTimeinfo(updateTimeinfo);
+        }
+    }
+
+    const QList<Group*> groups = m_rootGroup->groupsRecursive(true);
+    for (Group* group : groups) {
+        const QUuid replacement = duplicates.value(group->iconUuid());
+        if (!replacement.isNull()) {
+            const bool updateTimeinfo = group->canUpdateTimeinfo();
+            group->setUpdateTimeinfo(false);
+            group->setIcon(replacement);
+            group->setUpdateTimeinfo(updateTimeinfo);
+        }
+    }
+
+    for (auto it = duplicates.constBegin(); it != duplicates.constEnd(); ++it) {
+        m_metadata->removeCustomIcon(it.key());
+    }
+    return duplicates.size();
+}
+
+/**
+ * @return statistics of the database content, kept up to date as entries change
+ */
+DatabaseStatistics* Database::statistics() const
+{
+    return m_statistics.data();
+}
+
+/**
+ * @return index of the entry tags, kept up to date as entries change
+ */
+const TagIndex* Database::tagIndex() const
 {
-    return m_commonUsernames;
+    return m_tagIndex.data();
 }
 
-void Database::updateCommonUsernames(int topN)
+/**
+ * @return upcoming expiry times of the entries, entryExpired() is emitted as they pass
+ */
+const ExpiryScheduler* Database::expiryScheduler() const
 {
-    m_commonUsernames.clear();
-    m_commonUsernames.append(rootGroup()->usernamesRecursive(topN));
+    return m_expiryScheduler.data();
+}
+
+/**
+ * Find an entry of this database by its uuid, history items are not included.
+ * Entries are indexed when they are added to the database, so this does not
+ * scan the tree unless the uuid of an entry changed afterwards.
+ */
+Entry* Database::findEntryByUuid(const QUuid& uuid) const
+{
+    if (uuid.isNull() || !m_rootGroup) {
+        return nullptr;
+    }
+
+    Entry* entry = m_entryIndex.value(uuid);
+    if (entry && entry->uuid() == uuid && entry->database() == this) {
+        return entry;
+    }
+
+    for (auto* candidate : m_rootGroup->entriesRecursive(false)) {
+        if (candidate->uuid() == uuid) {
+            m_entryIndex.insert(uuid, candidate);
+            return candidate;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @return the most frequent usernames of the database entries
+ */
+QList<QString> Database::commonUsernames(int topN) const
+{
+    return m_usernameStatistics->topUsernames(topN);
 }
 
 const QUuid& Database::cipher() const
@@ -782,6 +1043,8 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
     }
 
     if (oldTransformedDatabaseKey.rawKey() != m_data.transformedDatabaseKey->rawKey()) {
+        // Journal records are keyed from the transformed key
+        m_journal->requireFullSave();
         markAsModified();
     }
 
@@ -850,21 +1113,57 @@ void Database::recycleGroup(Group* group)
     }
 }
 
+/**
+ * Delete the contents of the recycle bin in one go.
+ *
+ * The contents are detached from the database as a whole, so views and
+ * indexes are updated once per group instead of once per entry. Deletion
+ * records share a single timestamp and the detached objects are freed once
+ * control returns to the event loop.
+ */
 void Database::emptyRecycleBin()
 {
     Q_ASSERT(!m_data.isReadOnly);
-    if (m_metadata->recycleBinEnabled() && m_metadata->recycleBin()) {
-        // destroying direct entries of the recycle bin
-        QList<Entry*> subEntries = m_metadata->recycleBin()->entries();
-        for (Entry* entry : subEntries) {
-            delete entry;
-        }
-        // destroying direct subgroups of the recycle bin
-        QList<Group*> subGroups = m_metadata->recycleBin()->children();
-        for (Group* group : subGroups) {
-            delete group;
+    Group* recycleBin = m_metadata->recycleBin();
+    if (!m_metadata->recycleBinEnabled() || !recycleBin) {
+        return;
+    }
+
+    const QList<Entry*> entries = recycleBin->entriesRecursive();
+    const QList<Group*> groups = recycleBin->groupsRecursive(false);
+    if (entries.isEmpty() && groups.isEmpty()) {
+        return;
+    }
+
+    Tracing::Span span("Database::emptyRecycleBin");
+    span.setArg("entries", entries.size());
+    span.setArg("groups", groups.size());
+
+    DeletedObject delObj;
+    delObj.deletionTime = Clock::currentDateTimeUtc();
+    m_deletedObjects.reserve(m_deletedObjects.size() + entries.size() + groups.size());
+    for (const Entry* entry : entries) {
+        delObj.uuid = entry->uuid();
+        addDeletedObject(delObj);
+    }
+    for (const Group* group : groups) {
+        delObj.uuid = group->uuid();
+        addDeletedObject(delObj);
+    }
+
+    Group* contents = recycleBin->takeContents();
+
+    // Listeners were notified once by takeContents(), the destruction must not reach them again
+    for (Entry* entry : entries) {
+        entry->disconnect();
+        for (Entry* historyItem : entry->historyItems()) {
+            historyItem->disconnect();
         }
     }
+    for (Group* group : groups) {
+        group->disconnect();
+    }
+    contents->deleteLater();
 }
 
 bool Database::isModified() const
@@ -878,6 +1177,42 @@ bool Database::hasNonDataChanges() const
 }
 
 void Database::markAsModified()
+{
+    // The journal cannot tell what changed
+    m_journal->requireFullSave();
+    setModifiedFlag();
+}
+
+/**
+ * Slot for the modified signal of the entries in this database
+ */
+void Database::markEntryAsModified()
+{
+    auto* entry = qobject_cast<Entry*>(sender());
+    if (entry) {
+        m_journal->markEntryChanged(entry);
+        emit entryModified(entry);
+    } else {
+        m_journal->requireFullSave();
+    }
+    setModifiedFlag();
+}
+
+/**
+ * Slot for the modified signal of the groups in this database
+ */
+void Database::markGroupAsModified()
+{
+    auto* group = qobject_cast<Group*>(sender());
+    if (group) {
+        m_journal->markGroupChanged(group);
+    } else {
+        m_journal->requireFullSave();
+    }
+    setModifiedFlag();
+}
+
+void Database::setModifiedFlag()
 {
     m_modified = true;
     if (!m_modifiedTimer.isActive()) {
@@ -942,6 +1277,7 @@ bool Database::changeKdf(const QSharedPointer<Kdf>& kdf)
 
     setKdf(kdf);
     m_data.transformedDatabaseKey->setHash(transformedDatabaseKey);
+    m_journal->requireFullSave();
     markAsModified();
 
     return true;
@@ -34,12 +34,17 @@
 #include "keys/CompositeKey.h"
 #include "keys/PasswordKey.h"
 
+class DatabaseJournal;
+class DatabaseStatistics;
 class Entry;
+class ExpiryScheduler;
 enum class EntryReferenceType;
 class FileWatcher;
 class Group;
 class Metadata;
 class QIODevice;
+class TagIndex;
+class UsernameStatistics;
 
 struct DeletedObject
 {
@@ -77,6 +82,9 @@ public:
     bool save(QString* error = nullptr, bool atomic = true, bool backup = false);
     bool saveAs(const QString& filePath, QString* error = nullptr, bool atomic = true, bool backup = false);
     bool extract(QByteArray&, QString* error = nullptr);
+    bool appendToJournal(QString* error = nullptr);
+    void discardJournal();
+    qint64 journalSize() const;
     bool import(const QString& xmlExportPath, QString* error = nullptr);
 
     void releaseData();
@@ -112,8 +120,17 @@ public:
     bool containsDeletedObject(const QUuid& uuid) const;
     bool containsDeletedObject(const DeletedObject& uuid) const;
     void setDeletedObjects(const QList<DeletedObject>& delObjs);
-
-    QList<QString> commonUsernames();
+    void truncateDeletedObjects(int count);
+    int deletedObjectsMaxAge() const;
+    void setDeletedObjectsMaxAge(int days);
+    int pruneDeletedObjects();
+    int mergeDuplicateCustomIcons();
+
+    QList<QString> commonUsernames(int topN = 10) const;
+    DatabaseStatistics* statistics() const;
+    const TagIndex* tagIndex() const;
+    const ExpiryScheduler* expiryScheduler() const;
+    Entry* findEntryByUuid(const QUuid& uuid) const;
 
     QSharedPointer<const CompositeKey> key() const;
     bool setKey(const QSharedPointer<const CompositeKey>& key,
@@ -137,8 +154,9 @@ public:
 
 public slots:
     void markAsModified();
+    void markEntryAsModified();
+    void markGroupAsModified();
     void markAsClean();
-    void updateCommonUsernames(int topN = 10);
     void markNonDataChange();
 
 signals:
@@ -150,6 +168,13 @@ signals:
     void groupRemoved();
     void groupAboutToMove(Group* group, Group* toGroup, int index);
     void groupMoved();
+    void groupChildrenAboutToBeTaken(Group* group);
+    void groupChildrenTaken();
+    void entryAdded(Entry* entry);
+    void entryAboutToRemove(Entry* entry);
+    void entryDataChanged(Entry* entry);
+    void entryModified(Entry* entry);
+    void entryExpired(Entry* entry);
     void databaseOpened();
     void databaseSaved();
     void databaseDiscarded();
@@ -203,19 +228,26 @@ private:
     bool performSave(const QString& filePath, QString* error, bool atomic, bool backup);
     void startModifiedTimer();
     void stopModifiedTimer();
+    void setModifiedFlag();
 
     QPointer<Metadata> const m_metadata;
     DatabaseData m_data;
     QPointer<Group> m_rootGroup;
     QList<DeletedObject> m_deletedObjects;
+    QHash<QUuid, int> m_deletedObjectIndex;
+    mutable QHash<QUuid, QPointer<Entry>> m_entryIndex;
     QTimer m_modifiedTimer;
     QMutex m_saveMutex;
     QPointer<FileWatcher> m_fileWatcher;
+    QScopedPointer<DatabaseJournal> m_journal;
     bool m_modified = false;
     bool m_hasNonDataChange = false;
     QString m_keyError;
 
-    QList<QString> m_commonUsernames;
+    QScopedPointer<UsernameStatistics> m_usernameStatistics;
+    QScopedPointer<DatabaseStatistics> m_statistics;
+    QScopedPointer<TagIndex> m_tagIndex;
+    QScopedPointer<ExpiryScheduler> m_expiryScheduler;
 
     QUuid m_uuid;
     static QHash<QUuid, QPointer<Database>> s_uuidMap;
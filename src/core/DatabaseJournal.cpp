@@ -0,0 +1,419 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseJournal.h"
+
+#include "core/Database.h"
+#include "core/Endian.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+#include "crypto/CryptoHash.h"
+#include "crypto/kdf/AesKdf.h"
+#include "format/KeePass2Reader.h"
+#include "format/KeePass2Writer.h"
+#include "keys/PasswordKey.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+
+#include <functional>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const QByteArray JournalSignature("KPXCJRNL");
+    constexpr quint32 JournalVersion = 1;
+
+    bool syncToDisk(QFile& file)
+    {
+        if (!file.flush()) {
+            return false;
+        }
+#if defined(Q_OS_WIN)
+        return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(file.handle())));
+#elif defined(Q_OS_UNIX)
+        return ::fsync(file.handle()) == 0;
+#else
+        return true;
+#endif
+    }
+} // namespace
+
+DatabaseJournal::DatabaseJournal(Database* db)
+    : m_db(db)
+{
+}
+
+QString DatabaseJournal::journalPath(const QString& filePath)
+{
+    return filePath + ".journal";
+}
+
+bool DatabaseJournal::exists() const
+{
+    return !m_db->filePath().isEmpty() && QFile::exists(journalPath(m_db->filePath()));
+}
+
+qint64 DatabaseJournal::size() const
+{
+    if (m_db->filePath().isEmpty()) {
+        return 0;
+    }
+    return QFileInfo(journalPath(m_db->filePath())).size();
+}
+
+/**
+ * The journal is keyed from the transformed database key, so it is exactly as
+ * hard to attack as the database itself while needing only one AES-KDF round.
+ */
+QSharedPointer<const CompositeKey> DatabaseJournal::journalKey() const
+{
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(PasswordKey::fromRawKey(
+        CryptoHash::hmac("KeePassXC database journal", m_db->transformedDatabaseKey(), CryptoHash::Sha256)));
+    return key;
+}
+
+/**
+ * Append all entries and groups changed since the last record, as well as
+ * all new deletions, to the journal and sync it to disk.
+ *
+ * @param error error message, also set if a full save is required instead
+ * @return true if the changes are durably stored in the journal
+ */
+bool DatabaseJournal::append(QString* error)
+{
+    if (m_requiresFullSave || m_db->filePath().isEmpty() || m_db->transformedDatabaseKey().isEmpty()) {
+        if (error) {
+            *error = QObject::tr("Database changes cannot be journaled and require a full save.");
+        }
+        return false;
+    }
+
+    Database journalDb;
+    auto kdf = QSharedPointer<AesKdf>::create();
+    kdf->setRounds(1);
+    journalDb.setKdf(kdf);
+    journalDb.setKey(journalKey());
+
+    const Group* rootGroup = m_db->rootGroup();
+    auto* journalRoot = rootGroup->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+    auto* obsoleteRoot = journalDb.rootGroup();
+    journalDb.setRootGroup(journalRoot);
+    delete obsoleteRoot;
+
+    // Mirror the group hierarchy of changed items so they are applied in the right place
+    QHash<QUuid, Group*> mirroredGroups;
+    mirroredGroups.insert(journalRoot->uuid(), journalRoot);
+    std::function<Group*(const Group*)> mirrorGroup = [&](const Group* group) -> Group* {
+        auto* mirrored = mirroredGroups.value(group->uuid());
+        if (!mirrored) {
+            mirrored = group->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+            mirrored->setUpdateTimeinfo(false);
+            mirrored->setParent(mirrorGroup(group->parentGroup()));
+            mirroredGroups.insert(group->uuid(), mirrored);
+        }
+        return mirrored;
+    };
+
+    const Metadata* metadata = m_db->metadata();
+    auto copyCustomIcon = [&](const QUuid& uuid) {
+        if (!uuid.isNull() && metadata->hasCustomIcon(uuid) && !journalDb.metadata()->hasCustomIcon(uuid)) {
+            journalDb.metadata()->addCustomIcon(uuid, metadata->customIconData(uuid));
+        }
+    };
+
+    int changes = 0;
+    for (const Group* group : rootGroup->groupsRecursive(true)) {
+        if (m_changedGroups.contains(group->uuid())) {
+            mirrorGroup(group);
+            copyCustomIcon(group->iconUuid());
+            ++changes;
+        }
+        for (const Entry* entry : group->entries()) {
+            if (!m_changedEntries.contains(entry->uuid())) {
+                continue;
+            }
+            auto* clonedEntry = entry->clone(Entry::CloneIncludeHistory);
+            clonedEntry->setUpdateTimeinfo(false);
+            clonedEntry->setGroup(mirrorGroup(group));
+            copyCustomIcon(entry->iconUuid());
+            ++changes;
+        }
+    }
+
+    if (!m_deletedObjects.isEmpty()) {
+        // Records dropped again since, e.g. by an undone merge, are not journaled
+        for (const DeletedObject& deletedObject : m_db->deletedObjects()) {
+            if (m_deletedObjects.contains(deletedObject.uuid)) {
+                journalDb.addDeletedObject(deletedObject);
+                ++changes;
+            }
+        }
+    }
+
+    if (changes > 0) {
+        QByteArray record;
+        QBuffer buffer(&record);
+        buffer.open(QIODevice::WriteOnly);
+        KeePass2Writer writer;
+        if (!writer.writeDatabase(&buffer, &journalDb)) {
+            if (error) {
+                *error = writer.errorString();
+            }
+            return false;
+        }
+        if (!writeRecord(record, error)) {
+            return false;
+        }
+    }
+
+    m_changedEntries.clear();
+    m_changedGroups.clear();
+    m_deletedObjects.clear();
+    return true;
+}
+
+bool DatabaseJournal::writeRecord(const QByteArray& record, QString* error)
+{
+    QFile file(journalPath(m_db->filePath()));
+    bool isNewFile = !file.exists();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    if (isNewFile) {
+        file.setPermissions(QFile::ReadUser | QFile::WriteUser);
+    }
+
+    bool ok = true;
+    if (file.size() == 0) {
+        ok = file.write(JournalSignature) == JournalSignature.size()
+             && Endian::writeSizedInt<quint32>(JournalVersion, &file, KeePass2::BYTEORDER);
+    }
+    ok = ok && Endian::writeSizedInt<quint32>(static_cast<quint32>(record.size()), &file, KeePass2::BYTEORDER)
+         && file.write(record) == record.size() && syncToDisk(file);
+
+    if (!ok && error) {
+        *error = file.errorString();
+    }
+    return ok;
+}
+
+/**
+ * Apply all journal records to the database.
+ *
+ * A truncated final record (interrupted append) is ignored. A journal that
+ * cannot be decrypted is moved aside instead of being deleted.
+ *
+ * @param error error message if the journal could not be read completely
+ * @return number of applied records
+ */
+int DatabaseJournal::replay(QString* error)
+{
+    int applied = 0;
+    const QString path = journalPath(m_db->filePath());
+    QFile file(path);
+    if (m_db->filePath().isEmpty() || !file.exists()) {
+        checkpoint(false);
+        return applied;
+    }
+
+    bool failed = false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        failed = true;
+        if (error) {
+            *error = file.errorString();
+        }
+    } else {
+        bool ok = file.read(JournalSignature.size()) == JournalSignature;
+        if (ok) {
+            const quint32 version = Endian::readSizedInt<quint32>(&file, KeePass2::BYTEORDER, &ok);
+            ok = ok && version == JournalVersion;
+        }
+        if (!ok) {
+            failed = true;
+            if (error) {
+                *error = QObject::tr("Unsupported database journal format.");
+            }
+        }
+
+        const auto key = journalKey();
+        while (!failed && !file.atEnd()) {
+            const quint32 length = Endian::readSizedInt<quint32>(&file, KeePass2::BYTEORDER, &ok);
+            if (!ok) {
+                break;
+            }
+            QByteArray record = file.read(length);
+            if (record.size() != static_cast<int>(length)) {
+                break;
+            }
+
+            QBuffer buffer(&record);
+            buffer.open(QIODevice::ReadOnly);
+            Database journalDb;
+            KeePass2Reader reader;
+            if (!reader.readDatabase(&buffer, key, &journalDb)) {
+                failed = true;
+                if (error) {
+                    *error = QObject::tr("Could not read database journal: %1").arg(reader.errorString());
+                }
+                break;
+            }
+
+            applyRecord(&journalDb);
+            ++applied;
+        }
+        file.close();
+    }
+
+    if (failed) {
+        const QString unreadablePath = path + ".unreadable";
+        QFile::remove(unreadablePath);
+        QFile::rename(path, unreadablePath);
+    }
+
+    checkpoint(false);
+    return applied;
+}
+
+/**
+ * Overwrite the database with the items of a record.
+ *
+ * Records always hold the latest state of their items, so they are applied
+ * as they are instead of being merged by modification time, which would
+ * drop changes that did not update the time stamps.
+ */
+void DatabaseJournal::applyRecord(Database* record)
+{
+    Group* targetRoot = m_db->rootGroup();
+    for (Group* group : targetRoot->groupsRecursive(true)) {
+        group->setUpdateTimeinfo(false);
+    }
+    m_db->metadata()->copyCustomIcons(record->metadata()->customIconsOrder().toSet(), record->metadata());
+
+    // Parents come before their children
+    const QList<Group*> recordGroups = record->rootGroup()->groupsRecursive(true);
+    for (const Group* group : recordGroups) {
+        Group* target = targetRoot->findGroupByUuid(group->uuid());
+        Group* parent = group->parentGroup() ? targetRoot->findGroupByUuid(group->parentGroup()->uuid()) : nullptr;
+        if (!target) {
+            target = group->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+            target->setParent(parent ? parent : targetRoot);
+        } else {
+            if (parent && target->parentGroup() != parent) {
+                target->setParent(parent);
+            }
+            target->copyDataFrom(group);
+        }
+
+        for (const Entry* entry : group->entries()) {
+            Entry* targetEntry = targetRoot->findEntryByUuid(entry->uuid());
+            if (!targetEntry) {
+                targetEntry = entry->clone(Entry::CloneIncludeHistory);
+                targetEntry->setUpdateTimeinfo(false);
+            } else {
+                targetEntry->setUpdateTimeinfo(false);
+                targetEntry->copyDataFrom(entry);
+                targetEntry->removeHistoryItems(targetEntry->historyItems());
+                for (const Entry* historyItem : entry->historyItems()) {
+                    targetEntry->addHistoryItem(historyItem->clone(Entry::CloneNoFlags));
+                }
+            }
+            targetEntry->setGroup(target);
+            targetEntry->setUpdateTimeinfo(true);
+        }
+    }
+
+    for (const DeletedObject& deletedObject : record->deletedObjects()) {
+        if (Entry* entry = targetRoot->findEntryByUuid(deletedObject.uuid)) {
+            delete entry;
+        } else if (Group* group = targetRoot->findGroupByUuid(deletedObject.uuid)) {
+            if (group != targetRoot) {
+                delete group;
+            }
+        }
+        m_db->addDeletedObject(deletedObject);
+    }
+
+    for (Group* group : targetRoot->groupsRecursive(true)) {
+        group->setUpdateTimeinfo(true);
+    }
+}
+
+/**
+ * Mark the current database state as fully persisted.
+ *
+ * @param removeFile remove the journal, its changes are part of the database file
+ */
+void DatabaseJournal::checkpoint(bool removeFile)
+{
+    if (removeFile && !m_db->filePath().isEmpty()) {
+        QFile::remove(journalPath(m_db->filePath()));
+    }
+    m_changedEntries.clear();
+    m_changedGroups.clear();
+    m_deletedObjects.clear();
+    m_requiresFullSave = false;
+}
+
+/**
+ * Remove the journal when its changes are thrown away, so they are not
+ * replayed the next time the database is opened.
+ */
+void DatabaseJournal::discard()
+{
+    checkpoint(true);
+}
+
+/**
+ * Metadata, key and KDF changes as well as changes that cannot be attributed
+ * to an entry or group are not journaled, the next append will fail until
+ * the database has been saved.
+ */
+void DatabaseJournal::requireFullSave()
+{
+    m_requiresFullSave = true;
+}
+
+void DatabaseJournal::markEntryChanged(const Entry* entry)
+{
+    m_changedEntries.insert(entry->uuid());
+}
+
+void DatabaseJournal::markGroupChanged(const Group* group)
+{
+    m_changedGroups.insert(group->uuid());
+}
+
+/**
+ * Called for every deletion, also when the uuid already has a deletion
+ * record, so deleting an item again after it was restored is journaled.
+ */
+void DatabaseJournal::markDeleted(const QUuid& uuid)
+{
+    m_deletedObjects.insert(uuid);
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASEJOURNAL_H
+#define KEEPASSXC_DATABASEJOURNAL_H
+
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QUuid>
+
+class CompositeKey;
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Encrypted, append-only change journal stored next to a database file.
+ *
+ * Each record contains the entries and groups changed since the previous
+ * record, plus new deletions, as a small KDBX 4 container. Records are keyed
+ * with a key derived from the transformed database key, so they only need a
+ * single AES round instead of a full KDF run. On open, records are applied
+ * to the database; a full save folds them into the main file and removes
+ * the journal. Changes that cannot be attributed to an entry or group require
+ * a full save instead.
+ */
+class DatabaseJournal
+{
+public:
+    explicit DatabaseJournal(Database* db);
+
+    static QString journalPath(const QString& filePath);
+
+    bool exists() const;
+    qint64 size() const;
+
+    bool append(QString* error = nullptr);
+    int replay(QString* error = nullptr);
+    void checkpoint(bool removeFile);
+    void discard();
+    void requireFullSave();
+    void markEntryChanged(const Entry* entry);
+    void markGroupChanged(const Group* group);
+    void markDeleted(const QUuid& uuid);
+
+private:
+    QSharedPointer<const CompositeKey> journalKey() const;
+    bool writeRecord(const QByteArray& record, QString* error);
+    void applyRecord(Database* record);
+
+    Database* const m_db;
+    // Entries and groups changed since the last record, reported by the database signals
+    QSet<QUuid> m_changedEntries;
+    QSet<QUuid> m_changedGroups;
+    // Deletions recorded since the last record, including uuids that already had a deletion record
+    QSet<QUuid> m_deletedObjects;
+    bool m_requiresFullSave = false;
+};
+
+#endif // KEEPASSXC_DATABASEJOURNAL_H
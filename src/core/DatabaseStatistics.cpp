@@ -0,0 +1,493 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseStatistics.h"
+
+#include "core/Clock.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+#include "core/PasswordHealth.h"
+#include "crypto/CryptoHash.h"
+#include "crypto/Random.h"
+
+#include <QSet>
+#include <cmath>
+
+namespace
+{
+    // Rough size of the private data and allocation headers of a QObject
+    constexpr qint64 ObjectOverhead = 128;
+    // Rough size of a node in Qt's associative containers
+    constexpr qint64 NodeOverhead = 3 * sizeof(void*);
+
+    /**
+     * Measures Qt containers, counting implicitly shared data once
+     */
+    class MemoryMeter
+    {
+    public:
+        qint64 string(const QString& string)
+        {
+            if (string.isEmpty() || isShared(string.constData())) {
+                return 0;
+            }
+            return sizeof(QArrayData) + (string.capacity() + 1) * sizeof(QChar);
+        }
+
+        qint64 bytes(const QByteArray& bytes)
+        {
+            if (bytes.isEmpty() || isShared(bytes.constData())) {
+                return 0;
+            }
+            return sizeof(QArrayData) + bytes.capacity() + 1;
+        }
+
+        qint64 customData(const CustomData* customData)
+        {
+            qint64 size = 0;
+            for (const QString& key : customData->keys()) {
+                size += NodeOverhead + string(key) + string(customData->value(key));
+            }
+            return size;
+        }
+
+        void entry(const Entry* entry, qint64& entrySize, DatabaseStatistics::MemoryUsage& usage)
+        {
+            entrySize += sizeof(Entry) + sizeof(EntryAttributes) + sizeof(EntryAttachments)
+                         + sizeof(AutoTypeAssociations) + sizeof(CustomData) + 5 * ObjectOverhead;
+            const EntryAttributes* attributes = entry->attributes();
+            for (const QString& key : attributes->keys()) {
+                entrySize += NodeOverhead + string(key) + string(attributes->value(key));
+            }
+            for (const auto& association : entry->autoTypeAssociations()->getAll()) {
+                entrySize += sizeof(association) + string(association.window) + string(association.sequence);
+            }
+            entrySize += string(entry->tags()) + string(entry->defaultAutoTypeSequence());
+
+            const EntryAttachments* attachments = entry->attachments();
+            for (const QString& key : attachments->keys()) {
+                usage.attachments += NodeOverhead + string(key) + bytes(attachments->value(key));
+            }
+            usage.customData += customData(entry->customData());
+        }
+
+    private:
+        bool isShared(const void* data)
+        {
+            if (m_seen.contains(data)) {
+                return true;
+            }
+            m_seen.insert(data);
+            return false;
+        }
+
+        QSet<const void*> m_seen;
+    };
+} // namespace
+
+qint64 DatabaseStatistics::MemoryUsage::total() const
+{
+    return entries + history + attachments + icons + customData + groups + deletedObjects;
+}
+
+DatabaseStatistics::DatabaseStatistics(const Database* db)
+    : m_db(db)
+    , m_salt(randomGen()->randomArray(32))
+{
+}
+
+void DatabaseStatistics::addEntry(const Entry* entry)
+{
+    if (m_entries.contains(entry)) {
+        updateEntry(entry);
+        return;
+    }
+    const EntryRecord record = makeRecord(entry);
+    account(record, 1);
+    m_entries.insert(entry, record);
+    m_staleSizes.insert(entry);
+}
+
+void DatabaseStatistics::removeEntry(const Entry* entry)
+{
+    auto it = m_entries.find(entry);
+    if (it == m_entries.end()) {
+        return;
+    }
+    account(it.value(), -1);
+    m_entries.erase(it);
+    m_staleSizes.remove(entry);
+}
+
+/**
+ * Recount an entry that is already known, e.g. after it was modified
+ */
+void DatabaseStatistics::updateEntry(const Entry* entry)
+{
+    auto it = m_entries.find(entry);
+    if (it == m_entries.end()) {
+        return;
+    }
+    EntryRecord record = makeRecord(entry);
+    // Sizes are recomputed when they are read
+    record.size = it.value().size;
+    record.historySize = it.value().historySize;
+    account(it.value(), -1);
+    account(record, 1);
+    it.value() = record;
+    m_staleSizes.insert(entry);
+}
+
+/**
+ * Recount groups and recycled entries on the next read
+ */
+void DatabaseStatistics::invalidate()
+{
+    m_outdated = true;
+}
+
+int DatabaseStatistics::groupCount()
+{
+    refresh();
+    return m_groupCount;
+}
+
+int DatabaseStatistics::entryCount()
+{
+    refresh();
+    return m_entryCount;
+}
+
+int DatabaseStatistics::expiredEntries()
+{
+    refresh();
+    const QDateTime now = Clock::currentDateTimeUtc();
+    int expired = 0;
+    for (auto it = m_expiryTimes.constBegin(); it != m_expiryTimes.constEnd() && it.key() < now; ++it) {
+        expired += it.value();
+    }
+    return expired;
+}
+
+int DatabaseStatistics::excludedEntries()
+{
+    refresh();
+    return m_excludedEntries;
+}
+
+/**
+ * Number of weak or poor passwords as rated by the health check.
+ * Very long passwords and most passphrases are not rated.
+ */
+int DatabaseStatistics::weakPasswords()
+{
+    refresh();
+    int weak = 0;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        const EntryRecord& record = it.value();
+        if (!isRated(record)) {
+            continue;
+        }
+
+        auto entropy = m_entropies.constFind(record.passwordDigest);
+        if (entropy == m_entropies.constEnd()) {
+            entropy = m_entropies.insert(record.passwordDigest, PasswordHealth(it.key()->password()).entropy());
+        }
+
+        PasswordHealth health(entropy.value());
+        HealthChecker::adjustForReuse(&health, m_healthUses.value(record.passwordDigest));
+        HealthChecker::adjustForExpiry(&health, it.key());
+        if (health.quality() <= PasswordHealth::Quality::Weak) {
+            ++weak;
+        }
+    }
+    return weak;
+}
+
+/**
+ * Passwords rated by weakPasswords() whose entropy has not been estimated yet,
+ * read from the entries. Only keep the list while building a report.
+ */
+QStringList DatabaseStatistics::unratedPasswords()
+{
+    refresh();
+    QSet<QString> unrated;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (isRated(it.value()) && !m_entropies.contains(it.value().passwordDigest)) {
+            unrated.insert(it.key()->password());
+        }
+    }
+    return unrated.values();
+}
+
+void DatabaseStatistics::addPasswordRatings(const QHash<QString, double>& entropies)
+{
+    for (auto it = entropies.constBegin(); it != entropies.constEnd(); ++it) {
+        const QByteArray digest = passwordDigest(it.key());
+        // Only keep ratings of passwords that are still in use
+        if (m_passwordUses.contains(digest)) {
+            m_entropies.insert(digest, it.value());
+        }
+    }
+}
+
+/**
+ * Estimate the entropy of each password. This only works on the given
+ * strings, so it can run on any thread.
+ */
+QHash<QString, double> DatabaseStatistics::ratePasswords(const QStringList& passwords)
+{
+    QHash<QString, double> entropies;
+    for (const QString& password : passwords) {
+        entropies.insert(password, PasswordHealth(password).entropy());
+    }
+    return entropies;
+}
+
+int DatabaseStatistics::shortPasswords()
+{
+    refresh();
+    return m_shortPasswords;
+}
+
+int DatabaseStatistics::uniquePasswords()
+{
+    refresh();
+    return m_passwordUses.size();
+}
+
+int DatabaseStatistics::reusedPasswords()
+{
+    refresh();
+    return m_passwordCount - m_passwordUses.size();
+}
+
+/**
+ * Maximum number of entries sharing the same password
+ */
+int DatabaseStatistics::maxPasswordReuse()
+{
+    refresh();
+    int maxReuse = 0;
+    for (int uses : asConst(m_passwordUses)) {
+        maxReuse = qMax(maxReuse, uses);
+    }
+    return maxReuse;
+}
+
+int DatabaseStatistics::averagePasswordLength()
+{
+    refresh();
+    return m_passwordCount == 0 ? 0 : std::round(m_totalPasswordLength / double(m_passwordCount));
+}
+
+/**
+ * Size of the data of all entries in bytes, without history
+ */
+qint64 DatabaseStatistics::entriesSize()
+{
+    refresh();
+    refreshSizes();
+    return m_entriesSize;
+}
+
+/**
+ * Size of the history items of all entries in bytes
+ */
+qint64 DatabaseStatistics::historySize()
+{
+    refresh();
+    refreshSizes();
+    return m_historySize;
+}
+
+/**
+ * Estimate the memory used by the database content. Caches of the user
+ * interface, e.g. scaled icons and item models, are not included.
+ */
+DatabaseStatistics::MemoryUsage DatabaseStatistics::memoryUsage() const
+{
+    MemoryUsage usage;
+    MemoryMeter meter;
+
+    if (m_db->rootGroup()) {
+        for (const Group* group : m_db->rootGroup()->groupsRecursive(true)) {
+            usage.groups += sizeof(Group) + sizeof(CustomData) + 2 * ObjectOverhead;
+            usage.groups += meter.string(group->name()) + meter.string(group->notes());
+            usage.customData += meter.customData(group->customData());
+
+            for (const Entry* entry : group->entries()) {
+                meter.entry(entry, usage.entries, usage);
+                for (const Entry* historyItem : entry->historyItems()) {
+                    meter.entry(historyItem, usage.history, usage);
+                }
+            }
+        }
+    }
+
+    const Metadata* metadata = m_db->metadata();
+    usage.customData += meter.customData(metadata->customData());
+    for (const QUuid& uuid : metadata->customIconsOrder()) {
+        const QImage icon = metadata->customIcon(uuid);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+        usage.icons += NodeOverhead + icon.sizeInBytes();
+#else
+        usage.icons += NodeOverhead + icon.byteCount();
+#endif
+    }
+
+    usage.deletedObjects = m_db->deletedObjects().size() * (sizeof(DeletedObject) + NodeOverhead);
+    return usage;
+}
+
+/**
+ * Record of the counted properties of an entry. Sizes are left at zero,
+ * refreshSizes() computes them.
+ */
+DatabaseStatistics::EntryRecord DatabaseStatistics::makeRecord(const Entry* entry) const
+{
+    EntryRecord record;
+    const QString password = entry->password();
+    record.passwordDigest = passwordDigest(password);
+    record.passwordLength = password.size();
+    record.passwordReference = entry->isAttributeReference(EntryAttributes::PasswordKey);
+    record.recycled = entry->isRecycled();
+    record.expires = entry->timeInfo().expires();
+    record.expiryTime = entry->timeInfo().expiryTime();
+    record.excluded = entry->excludeFromReports();
+    return record;
+}
+
+QByteArray DatabaseStatistics::passwordDigest(const QString& password) const
+{
+    return CryptoHash::hmac(password.toUtf8(), m_salt, CryptoHash::Sha256);
+}
+
+/**
+ * @return true if weakPasswords() rates the password of the entry, very long passwords are skipped
+ */
+bool DatabaseStatistics::isRated(const EntryRecord& record) const
+{
+    return !record.recycled && record.passwordLength > 0 && record.passwordLength < 25;
+}
+
+/**
+ * Add (sign = 1) or remove (sign = -1) the contribution of an entry
+ */
+void DatabaseStatistics::account(const EntryRecord& record, int sign)
+{
+    if (record.recycled) {
+        return;
+    }
+
+    m_entryCount += sign;
+    m_entriesSize += sign * record.size;
+    m_historySize += sign * record.historySize;
+
+    if (record.expires) {
+        int& count = m_expiryTimes[record.expiryTime];
+        count += sign;
+        if (count <= 0) {
+            m_expiryTimes.remove(record.expiryTime);
+        }
+    }
+
+    if (!record.passwordReference) {
+        int& count = m_healthUses[record.passwordDigest];
+        count += sign;
+        if (count <= 0) {
+            m_healthUses.remove(record.passwordDigest);
+        }
+    }
+
+    if (record.passwordLength == 0) {
+        return;
+    }
+
+    m_passwordCount += sign;
+    m_totalPasswordLength += sign * record.passwordLength;
+    if (record.passwordLength < 8) {
+        m_shortPasswords += sign;
+    }
+    if (record.excluded) {
+        m_excludedEntries += sign;
+    }
+
+    int& count = m_passwordUses[record.passwordDigest];
+    count += sign;
+    if (count <= 0) {
+        m_passwordUses.remove(record.passwordDigest);
+        m_entropies.remove(record.passwordDigest);
+    }
+}
+
+void DatabaseStatistics::refresh()
+{
+    if (!m_outdated) {
+        return;
+    }
+    m_outdated = false;
+
+    // Recycled state changes when groups move or the recycle bin changes
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        const bool recycled = it.key()->isRecycled();
+        if (recycled != it.value().recycled) {
+            account(it.value(), -1);
+            it.value().recycled = recycled;
+            account(it.value(), 1);
+        }
+    }
+
+    m_groupCount = 0;
+    if (m_db->rootGroup()) {
+        for (const Group* group : m_db->rootGroup()->groupsRecursive(true)) {
+            if (!group->isRecycled()) {
+                ++m_groupCount;
+            }
+        }
+    }
+}
+
+/**
+ * Compute the sizes of the entries that changed since the last read
+ */
+void DatabaseStatistics::refreshSizes()
+{
+    for (const Entry* entry : asConst(m_staleSizes)) {
+        auto it = m_entries.find(entry);
+        if (it == m_entries.end()) {
+            continue;
+        }
+
+        EntryRecord& record = it.value();
+        qint64 historySize = 0;
+        for (const Entry* historyItem : entry->historyItems()) {
+            historySize += historyItem->size();
+        }
+        const qint64 size = entry->size();
+        if (!record.recycled) {
+            m_entriesSize += size - record.size;
+            m_historySize += historySize - record.historySize;
+        }
+        record.size = size;
+        record.historySize = historySize;
+    }
+    m_staleSizes.clear();
+}
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASESTATISTICS_H
+#define KEEPASSXC_DATABASESTATISTICS_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class Database;
+class Entry;
+
+/**
+ * Statistics of a database that are kept up to date as entries change,
+ * so they can be read without walking the group tree.
+ *
+ * Entries and groups in the recycle bin are not counted. Moving groups
+ * or changing the recycle bin only marks the statistics as outdated;
+ * they are recounted on the next read. Entry sizes are recomputed when
+ * they are read, only for entries that changed since.
+ *
+ * Passwords are not kept. Reuse is counted by a salted digest of each
+ * password, and password ratings are computed from the entries while
+ * a report is built.
+ */
+class DatabaseStatistics
+{
+public:
+    /**
+     * Approximate heap usage of a database in bytes. Implicitly shared
+     * strings and attachment data are counted once.
+     */
+    struct MemoryUsage
+    {
+        qint64 entries = 0; // Entry objects, attributes, tags and auto-type associations
+        qint64 history = 0; // The same for history items
+        qint64 attachments = 0; // Attachment data of entries and history items
+        qint64 icons = 0; // Custom icon images
+        qint64 customData = 0; // Custom data of the database, groups, entries and history items
+        qint64 groups = 0; // Group objects, names and notes
+        qint64 deletedObjects = 0; // Deletion records
+
+        qint64 total() const;
+    };
+
+    explicit DatabaseStatistics(const Database* db);
+
+    void addEntry(const Entry* entry);
+    void removeEntry(const Entry* entry);
+    void updateEntry(const Entry* entry);
+    void invalidate();
+
+    int groupCount();
+    int entryCount();
+    int expiredEntries();
+    int excludedEntries();
+    int weakPasswords();
+    QStringList unratedPasswords();
+    void addPasswordRatings(const QHash<QString, double>& entropies);
+    static QHash<QString, double> ratePasswords(const QStringList& passwords);
+    int shortPasswords();
+    int uniquePasswords();
+    int reusedPasswords();
+    int maxPasswordReuse();
+    int averagePasswordLength();
+    qint64 entriesSize();
+    qint64 historySize();
+
+    MemoryUsage memoryUsage() const;
+
+private:
+    struct EntryRecord
+    {
+        QByteArray passwordDigest;
+        int passwordLength = 0;
+        QDateTime expiryTime;
+        qint64 size = 0;
+        qint64 historySize = 0;
+        bool recycled = false;
+        bool expires = false;
+        bool excluded = false;
+        bool passwordReference = false;
+    };
+
+    EntryRecord makeRecord(const Entry* entry) const;
+    QByteArray passwordDigest(const QString& password) const;
+    bool isRated(const EntryRecord& record) const;
+    void account(const EntryRecord& record, int sign);
+    void refresh();
+    void refreshSizes();
+
+    const Database* const m_db;
+    // Random key of the password digests, so they cannot be compared across databases or sessions
+    const QByteArray m_salt;
+    bool m_outdated = true;
+
+    QHash<const Entry*, EntryRecord> m_entries;
+    // Entries whose sizes changed since they were last computed
+    QSet<const Entry*> m_staleSizes;
+    int m_groupCount = 0;
+    int m_entryCount = 0;
+    int m_excludedEntries = 0;
+    int m_shortPasswords = 0;
+    int m_passwordCount = 0;
+    qint64 m_totalPasswordLength = 0;
+    qint64 m_entriesSize = 0;
+    qint64 m_historySize = 0;
+    // Number of counted entries per non-empty password digest
+    QHash<QByteArray, int> m_passwordUses;
+    // Number of entries per password digest as seen by the health check
+    QHash<QByteArray, int> m_healthUses;
+    // Number of counted entries per expiry time
+    QMap<QDateTime, int> m_expiryTimes;
+    // Password entropy is expensive to calculate and only depends on the password
+    QHash<QByteArray, double> m_entropies;
+};
+
+#endif // KEEPASSXC_DATABASESTATISTICS_H
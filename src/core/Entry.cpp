@@ -28,6 +28,7 @@
 
 #include <QDir>
 #include <QRegularExpression>
+#include <algorithm>
 #include <utility>
 
 const int Entry::DefaultIconNumber = 0;
@@ -50,6 +51,7 @@ Entry::Entry()
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::updateTotp);
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::modified);
     connect(m_attributes, &EntryAttributes::defaultKeyModified, this, &Entry::emitDataChanged);
+    connect(m_attributes, &EntryAttributes::reset, this, &Entry::emitDataChanged);
     connect(m_attachments, &EntryAttachments::modified, this, &Entry::modified);
     connect(m_autoTypeAssociations, &AutoTypeAssociations::modified, this, &Entry::modified);
     connect(m_customData, &CustomData::modified, this, &Entry::modified);
@@ -95,6 +97,52 @@ bool Entry::canUpdateTimeinfo() const
     return m_updateTimeinfo;
 }
 
+/**
+ * Case folded and NFKC normalized copy of a field for case insensitive
+ * matching with plain string comparisons, see foldString().
+ *
+ * The copy is computed on first use and again whenever the raw field has
+ * changed since. Placeholders are not resolved. Not thread safe.
+ */
+const QString& Entry::foldedField(FoldedField field) const
+{
+    QString source;
+    switch (field) {
+    case FoldedField::Title:
+        source = title();
+        break;
+    case FoldedField::Username:
+        source = username();
+        break;
+    case FoldedField::Url:
+    case FoldedField::Host:
+        source = url();
+        break;
+    case FoldedField::Tags:
+        source = tags();
+        break;
+    }
+
+    auto& cached = m_foldedFields[static_cast<int>(field)];
+    // Equal strings usually share their data, the comparison does not look at the characters then
+    if (!cached.valid || cached.source != source) {
+        cached.folded = foldString(field == FoldedField::Host ? QUrl(source).host() : source);
+        cached.source = source;
+        cached.valid = true;
+    }
+    return cached.folded;
+}
+
+/**
+ * Normalize a string for case insensitive matching. Strings that differ only
+ * in case or in compatibility forms (e.g. ligatures, full width letters) fold
+ * to the same result.
+ */
+QString Entry::foldString(const QString& str)
+{
+    return str.normalized(QString::NormalizationForm_KC).toCaseFolded();
+}
+
 void Entry::setUpdateTimeinfo(bool value)
 {
     m_updateTimeinfo = value;
@@ -339,6 +387,19 @@ QList<QString> Entry::autoTypeSequences(const QString& windowTitle) const
         return false;
     };
 
+    // Fields without a placeholder are matched through their cached folded copies
+    QString foldedWindowTitle;
+    auto foldedWindowMatches = [&](FoldedField field) {
+        const auto& folded = foldedField(field);
+        if (folded.isEmpty()) {
+            return false;
+        }
+        if (foldedWindowTitle.isNull()) {
+            foldedWindowTitle = foldString(windowTitle);
+        }
+        return foldedWindowTitle.contains(folded);
+    };
+
     QList<QString> sequenceList;
 
     // Add window association matches
@@ -355,13 +416,23 @@ QList<QString> Entry::autoTypeSequences(const QString& windowTitle) const
     }
 
     // Try to match window title
-    if (config()->get(Config::AutoTypeEntryTitleMatch).toBool() && windowMatchesTitle(resolvePlaceholder(title()))) {
-        sequenceList << effectiveAutoTypeSequence();
+    if (config()->get(Config::AutoTypeEntryTitleMatch).toBool()) {
+        const auto entryTitle = title();
+        if (entryTitle.contains('{') ? windowMatchesTitle(resolvePlaceholder(entryTitle))
+                                       : foldedWindowMatches(FoldedField::Title)) {
+            sequenceList << effectiveAutoTypeSequence();
+        }
     }
 
     // Try to match url in window title
-    if (config()->get(Config::AutoTypeEntryURLMatch).toBool() && windowMatchesUrl(resolvePlaceholder(url()))) {
-        sequenceList << effectiveAutoTypeSequence();
+    if (config()->get(Config::AutoTypeEntryURLMatch).toBool()) {
+        const auto entryUrl = url();
+        const bool matched = entryUrl.contains('{')
+                                 ? windowMatchesUrl(resolvePlaceholder(entryUrl))
+                                 : foldedWindowMatches(FoldedField::Url) || foldedWindowMatches(FoldedField::Host);
+        if (matched) {
+            sequenceList << effectiveAutoTypeSequence();
+        }
     }
 
     return sequenceList;
@@ -422,7 +493,7 @@ QString Entry::attribute(const QString& key) const
 int Entry::size() const
 {
     int size = 0;
-    const QRegularExpression delimiter(",|:|;");
+    static const QRegularExpression delimiter(",|:|;");
 
     size += this->attributes()->attributesSize();
     size += this->autoTypeAssociations()->associationsSize();
@@ -763,6 +834,22 @@ void Entry::removeHistoryItems(const QList<Entry*>& historyEntries)
     emitModified();
 }
 
+/**
+ * Restore the oldest to newest order of the history items, e.g. after
+ * adding items out of order
+ */
+void Entry::sortHistory()
+{
+    auto isOlder = [](const Entry* lhs, const Entry* rhs) {
+        return lhs->timeInfo().lastModificationTime() < rhs->timeInfo().lastModificationTime();
+    };
+    if (std::is_sorted(m_history.begin(), m_history.end(), isOlder)) {
+        return;
+    }
+    std::stable_sort(m_history.begin(), m_history.end(), isOlder);
+    emitModified();
+}
+
 void Entry::truncateHistory()
 {
     const Database* db = database();
@@ -791,7 +878,6 @@ void Entry::truncateHistory()
     int histMaxSize = db->metadata()->historyMaxSize();
     if (histMaxSize > -1) {
         int size = 0;
-        QSet<QByteArray> foundAttachments = attachments()->values();
 
         QMutableListIterator<Entry*> i(m_history);
         i.toBack();
@@ -801,7 +887,6 @@ void Entry::truncateHistory()
             // don't calculate size if it's already above the maximum
             if (size <= histMaxSize) {
                 size += historyItem->size();
-                foundAttachments += historyItem->attachments()->values();
             }
 
             if (size > histMaxSize) {
@@ -911,11 +996,21 @@ Entry* Entry::clone(CloneFlags flags) const
 void Entry::copyDataFrom(const Entry* other)
 {
     setUpdateTimeinfo(false);
+    const bool dataChanged = m_data != other->m_data;
+    const bool attributesChanged = *m_attributes != *other->m_attributes;
     m_data = other->m_data;
     m_customData->copyDataFrom(other->m_customData);
-    m_attributes->copyDataFrom(other->m_attributes);
     m_attachments->copyDataFrom(other->m_attachments);
     m_autoTypeAssociations->copyDataFrom(other->m_autoTypeAssociations);
+    // Copied last, so the data change it signals sees the whole entry
+    m_attributes->copyDataFrom(other->m_attributes);
+    if (dataChanged) {
+        // The other parts signal their own changes
+        emitModified();
+        if (!attributesChanged) {
+            emitDataChanged();
+        }
+    }
     setUpdateTimeinfo(true);
 }
 
@@ -158,6 +158,7 @@ public:
     const QList<Entry*>& historyItems() const;
     void addHistoryItem(Entry* entry);
     void removeHistoryItems(const QList<Entry*>& historyEntries);
+    void sortHistory();
     void truncateHistory();
 
     bool equals(const Entry* other, CompareItemOptions options = CompareItemDefault) const;
@@ -256,6 +257,18 @@ public:
     bool canUpdateTimeinfo() const;
     void setUpdateTimeinfo(bool value);
 
+    enum class FoldedField
+    {
+        Title,
+        Username,
+        Url,
+        Host,
+        Tags
+    };
+
+    const QString& foldedField(FoldedField field) const;
+    static QString foldString(const QString& str);
+
 signals:
     /**
      * Emitted when a default attribute has been changed.
@@ -279,6 +292,13 @@ private:
 
     template <class T> bool set(T& property, const T& value);
 
+    struct FoldedValue
+    {
+        QString source;
+        QString folded;
+        bool valid = false;
+    };
+
     QUuid m_uuid;
     EntryData m_data;
     QPointer<EntryAttributes> m_attributes;
@@ -291,6 +311,11 @@ private:
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+    // Computed on first use, indexed by FoldedField
+    mutable FoldedValue m_foldedFields[5];
+
+    // Group::takeContents() moves entries in bulk without per-entry signals
+    friend class Group;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
@@ -18,9 +18,57 @@
 #include "EntryAttachments.h"
 
 #include "core/Global.h"
+#include "crypto/CryptoHash.h"
 
+#include <QFutureInterface>
+#include <QIODevice>
+#include <QMutex>
 #include <QSet>
 #include <QStringList>
+#include <QtConcurrent>
+
+#include <limits>
+
+namespace
+{
+    // Attachments are copied in chunks of this size, between which progress is reported
+    constexpr qint64 ChunkSize = 1024 * 1024;
+    // Smaller attachments are hashed right away, starting a thread costs more than that
+    constexpr int BackgroundDigestSize = 64 * 1024;
+
+    QByteArray hashAttachment(const QByteArray& data)
+    {
+        return CryptoHash::hash(data, CryptoHash::Sha256);
+    }
+
+    QFuture<QByteArray> finishedFuture(const QByteArray& result)
+    {
+        QFutureInterface<QByteArray> futureInterface(QFutureInterfaceBase::Started);
+        futureInterface.reportFinished(&result);
+        return futureInterface.future();
+    }
+
+    /**
+     * Digests of the large attachment buffers currently in use, keyed by their
+     * data pointer. Loading a database sets the same buffer on an entry and
+     * all of its history items, those share one digest instead of hashing the
+     * buffer again. An AttachmentDigest holds a reference to its buffer, so the
+     * address cannot be reused while the registry entry is alive.
+     */
+    struct DigestRegistry
+    {
+        QMutex mutex;
+        QHash<const char*, QWeakPointer<const AttachmentDigest>> digests;
+    };
+
+    Q_GLOBAL_STATIC(DigestRegistry, s_digestRegistry)
+} // namespace
+
+struct AttachmentDigest
+{
+    QByteArray data;
+    QFuture<QByteArray> digest;
+};
 
 EntryAttachments::EntryAttachments(QObject* parent)
     : ModifiableObject(parent)
@@ -47,6 +95,30 @@ QByteArray EntryAttachments::value(const QString& key) const
     return m_attachments.value(key);
 }
 
+/**
+ * SHA-256 of an attachment, computed once when the attachment is set.
+ * Waits for the hashing to finish if it is still running.
+ *
+ * @return digest of the attachment or an empty array if there is no attachment with that key
+ */
+QByteArray EntryAttachments::digest(const QString& key) const
+{
+    const auto it = m_digests.constFind(key);
+    if (it == m_digests.constEnd()) {
+        return {};
+    }
+    return it.value()->digest.result();
+}
+
+QSet<QByteArray> EntryAttachments::digests() const
+{
+    QSet<QByteArray> digests;
+    for (auto it = m_digests.constBegin(); it != m_digests.constEnd(); ++it) {
+        digests.insert(it.value()->digest.result());
+    }
+    return digests;
+}
+
 void EntryAttachments::set(const QString& key, const QByteArray& value)
 {
     bool shouldEmitModified = false;
@@ -58,6 +130,7 @@ void EntryAttachments::set(const QString& key, const QByteArray& value)
 
     if (addAttachment || m_attachments.value(key) != value) {
         m_attachments.insert(key, value);
+        updateDigest(key);
         shouldEmitModified = true;
     }
 
@@ -72,6 +145,118 @@ void EntryAttachments::set(const QString& key, const QByteArray& value)
     }
 }
 
+/**
+ * Read an attachment from a device, replacing an attachment of the same name.
+ *
+ * The data is read in chunks straight into the buffer that is stored, so a
+ * file is held in memory only once. The attachments are left unchanged if
+ * reading fails or is canceled.
+ *
+ * @return true if the attachment was read completely
+ */
+bool EntryAttachments::importAttachment(const QString& key,
+                                        QIODevice* device,
+                                        QString* error,
+                                        const ProgressCallback& progress)
+{
+    const qint64 total = device->isSequential() ? -1 : device->size() - device->pos();
+    if (total > std::numeric_limits<int>::max()) {
+        if (error) {
+            *error = tr("The file is too large to be attached.");
+        }
+        return false;
+    }
+
+    QByteArray data;
+    if (total > 0) {
+        data.resize(static_cast<int>(total));
+    }
+
+    qint64 done = 0;
+    while (true) {
+        if (done == data.size()) {
+            // Only grow the buffer if the size is unknown or the file grew while reading
+            if (!device->isSequential() && device->atEnd()) {
+                break;
+            }
+            if (data.size() > std::numeric_limits<int>::max() - ChunkSize) {
+                if (error) {
+                    *error = tr("The file is too large to be attached.");
+                }
+                return false;
+            }
+            data.resize(static_cast<int>(data.size() + ChunkSize));
+        }
+
+        const qint64 read = device->read(data.data() + done, qMin(ChunkSize, data.size() - done));
+        if (read < 0) {
+            if (error) {
+                *error = device->errorString();
+            }
+            return false;
+        }
+        if (read == 0) {
+            if (device->isSequential() && device->waitForReadyRead(-1)) {
+                continue;
+            }
+            break;
+        }
+
+        done += read;
+        if (progress && !progress(done, total)) {
+            if (error) {
+                *error = tr("Canceled");
+            }
+            return false;
+        }
+    }
+
+    data.resize(static_cast<int>(done));
+    set(key, data);
+    return true;
+}
+
+/**
+ * Write an attachment to a device in chunks, without copying its data.
+ *
+ * @return true if the attachment was written completely
+ */
+bool EntryAttachments::exportAttachment(const QString& key,
+                                        QIODevice* device,
+                                        QString* error,
+                                        const ProgressCallback& progress) const
+{
+    if (!m_attachments.contains(key)) {
+        if (error) {
+            *error = tr("No attachment named %1.").arg(key);
+        }
+        return false;
+    }
+
+    const QByteArray data = m_attachments.value(key);
+    const qint64 total = data.size();
+    qint64 done = 0;
+    while (done < total) {
+        const qint64 written = device->write(data.constData() + done, qMin(ChunkSize, total - done));
+        if (written <= 0) {
+            if (error) {
+                *error = device->errorString();
+            }
+            return false;
+        }
+
+        done += written;
+        if (progress && !progress(done, total)) {
+            if (error) {
+                *error = tr("Canceled");
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void EntryAttachments::remove(const QString& key)
 {
     if (!m_attachments.contains(key)) {
@@ -82,6 +267,7 @@ void EntryAttachments::remove(const QString& key)
     emit aboutToBeRemoved(key);
 
     m_attachments.remove(key);
+    m_digests.remove(key);
 
     emit removed(key);
     emitModified();
@@ -104,6 +290,7 @@ void EntryAttachments::remove(const QStringList& keys)
         isModified = true;
         emit aboutToBeRemoved(key);
         m_attachments.remove(key);
+        m_digests.remove(key);
         emit removed(key);
     }
 
@@ -133,6 +320,7 @@ void EntryAttachments::clear()
     emit aboutToBeReset();
 
     m_attachments.clear();
+    m_digests.clear();
 
     emit reset();
     emitModified();
@@ -144,6 +332,8 @@ void EntryAttachments::copyDataFrom(const EntryAttachments* other)
         emit aboutToBeReset();
 
         m_attachments = other->m_attachments;
+        // The data is shared, so are the digests
+        m_digests = other->m_digests;
 
         emit reset();
         emitModified();
@@ -152,12 +342,60 @@ void EntryAttachments::copyDataFrom(const EntryAttachments* other)
 
 bool EntryAttachments::operator==(const EntryAttachments& other) const
 {
-    return m_attachments == other.m_attachments;
+    if (m_attachments.size() != other.m_attachments.size()) {
+        return false;
+    }
+
+    for (auto it = m_attachments.constBegin(); it != m_attachments.constEnd(); ++it) {
+        const auto otherIt = other.m_attachments.constFind(it.key());
+        if (otherIt == other.m_attachments.constEnd() || it.value().size() != otherIt.value().size()) {
+            return false;
+        }
+        // Compare the digests instead of the data, unless both share the same data anyway
+        if (it.value().constData() != otherIt.value().constData() && digest(it.key()) != other.digest(it.key())) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool EntryAttachments::operator!=(const EntryAttachments& other) const
 {
-    return m_attachments != other.m_attachments;
+    return !(*this == other);
+}
+
+void EntryAttachments::updateDigest(const QString& key)
+{
+    const QByteArray data = m_attachments.value(key);
+    if (data.size() < BackgroundDigestSize) {
+        m_digests.insert(key,
+                         QSharedPointer<const AttachmentDigest>(
+                             new AttachmentDigest{QByteArray(), finishedFuture(hashAttachment(data))}));
+        return;
+    }
+
+    // Reuse the digest of the same buffer held by another entry or history item
+    const char* address = data.constData();
+    QMutexLocker locker(&s_digestRegistry->mutex);
+    auto digest = s_digestRegistry->digests.value(address).toStrongRef();
+    if (!digest) {
+        auto unregister = [address](const AttachmentDigest* d) {
+            {
+                QMutexLocker locker(&s_digestRegistry->mutex);
+                auto it = s_digestRegistry->digests.find(address);
+                if (it != s_digestRegistry->digests.end() && it.value().isNull()) {
+                    s_digestRegistry->digests.erase(it);
+                }
+            }
+            delete d;
+        };
+        digest = QSharedPointer<const AttachmentDigest>(
+            new AttachmentDigest{data, QtConcurrent::run(hashAttachment, data)}, unregister);
+        s_digestRegistry->digests.insert(address, digest);
+    }
+    // Replacing the previous digest may unregister it
+    locker.unlock();
+    m_digests.insert(key, digest);
 }
 
 int EntryAttachments::attachmentsSize() const
@@ -18,24 +18,48 @@
 #ifndef KEEPASSX_ENTRYATTACHMENTS_H
 #define KEEPASSX_ENTRYATTACHMENTS_H
 
+#include <QFuture>
+#include <QHash>
 #include <QMap>
 #include <QObject>
+#include <QSharedPointer>
+
+#include <functional>
 
 #include "core/ModifiableObject.h"
 
+class QIODevice;
 class QStringList;
+struct AttachmentDigest;
 
 class EntryAttachments : public ModifiableObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * Called after every chunk copied by importAttachment() and exportAttachment()
+     * with the bytes copied so far and the total size, or -1 if the size is unknown.
+     * Returning false cancels the copy.
+     */
+    typedef std::function<bool(qint64 done, qint64 total)> ProgressCallback;
+
     explicit EntryAttachments(QObject* parent = nullptr);
     QList<QString> keys() const;
     bool hasKey(const QString& key) const;
     QSet<QByteArray> values() const;
     QByteArray value(const QString& key) const;
+    QByteArray digest(const QString& key) const;
+    QSet<QByteArray> digests() const;
     void set(const QString& key, const QByteArray& value);
+    bool importAttachment(const QString& key,
+                          QIODevice* device,
+                          QString* error = nullptr,
+                          const ProgressCallback& progress = {});
+    bool exportAttachment(const QString& key,
+                          QIODevice* device,
+                          QString* error = nullptr,
+                          const ProgressCallback& progress = {}) const;
     void remove(const QString& key);
     void remove(const QStringList& keys);
     void rename(const QString& key, const QString& newKey);
@@ -56,7 +80,11 @@ signals:
     void reset();
 
 private:
+    void updateDigest(const QString& key);
+
     QMap<QString, QByteArray> m_attachments;
+    // SHA-256 of every attachment, large ones are hashed outside the GUI thread
+    QHash<QString, QSharedPointer<const AttachmentDigest>> m_digests;
 };
 
 #endif // KEEPASSX_ENTRYATTACHMENTS_H
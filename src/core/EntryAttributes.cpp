@@ -116,6 +116,7 @@ void EntryAttributes::set(const QString& key, const QString& value, bool protect
 
     if (addAttribute || changeValue) {
         m_attributes.insert(key, value);
+        m_attributesSize = -1;
         shouldEmitModified = true;
     }
 
@@ -153,6 +154,7 @@ void EntryAttributes::remove(const QString& key)
 
     m_attributes.remove(key);
     m_protectedAttributes.remove(key);
+    m_attributesSize = -1;
 
     emit removed(key);
     emitModified();
@@ -180,6 +182,7 @@ void EntryAttributes::rename(const QString& oldKey, const QString& newKey)
 
     m_attributes.remove(oldKey);
     m_attributes.insert(newKey, data);
+    m_attributesSize = -1;
     if (protect) {
         m_protectedAttributes.remove(oldKey);
         m_protectedAttributes.insert(newKey);
@@ -215,6 +218,7 @@ void EntryAttributes::copyCustomKeysFrom(const EntryAttributes* other)
             }
         }
     }
+    m_attributesSize = -1;
 
     emit reset();
     emitModified();
@@ -248,6 +252,7 @@ void EntryAttributes::copyDataFrom(const EntryAttributes* other)
 
         m_attributes = other->m_attributes;
         m_protectedAttributes = other->m_protectedAttributes;
+        m_attributesSize = other->m_attributesSize;
 
         emit reset();
         emitModified();
@@ -301,6 +306,7 @@ void EntryAttributes::clear()
     for (const QString& key : DefaultAttributes) {
         m_attributes.insert(key, "");
     }
+    m_attributesSize = -1;
 
     emit reset();
     emitModified();
@@ -308,11 +314,15 @@ void EntryAttributes::clear()
 
 int EntryAttributes::attributesSize() const
 {
-    int size = 0;
-    for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().toUtf8().size();
+    // The size is cached until the attributes change
+    if (m_attributesSize < 0) {
+        int size = 0;
+        for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
+            size += it.key().toUtf8().size() + it.value().toUtf8().size();
+        }
+        m_attributesSize = size;
     }
-    return size;
+    return m_attributesSize;
 }
 
 bool EntryAttributes::isDefaultAttribute(const QString& key)
@@ -85,6 +85,7 @@ signals:
 private:
     QMap<QString, QString> m_attributes;
     QSet<QString> m_protectedAttributes;
+    mutable int m_attributesSize = -1;
 };
 
 #endif // KEEPASSX_ENTRYATTRIBUTES_H
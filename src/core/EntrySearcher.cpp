@@ -18,14 +18,31 @@
 
 #include "EntrySearcher.h"
 
+#include "core/Database.h"
 #include "core/Group.h"
+#include "core/TagIndex.h"
 #include "core/Tools.h"
+#include "core/Tracing.h"
+
+namespace
+{
+    // Group 1 = modifiers, Group 2 = field, Group 3 = quoted string, Group 4 = unquoted string
+    const QRegularExpression& termParser()
+    {
+        // Shared by all searchers so the parser is compiled only once
+        static const QRegularExpression parser = []() {
+            QRegularExpression regex(R"re(([-!*+]+)?(?:(\w*):)?(?:(?=")"((?:[^"\\]|\\.)*)"|([^ ]*))( |$))re");
+            regex.optimize();
+            return regex;
+        }();
+        return parser;
+    }
+} // namespace
 
 EntrySearcher::EntrySearcher(bool caseSensitive, bool skipProtected)
     : m_caseSensitive(caseSensitive)
     , m_skipProtected(skipProtected)
-    , m_termParser(R"re(([-!*+]+)?(?:(\w*):)?(?:(?=")"((?:[^"\\]|\\.)*)"|([^ ]*))( |$))re")
-// Group 1 = modifiers, Group 2 = field, Group 3 = quoted string, Group 4 = unquoted string
+    , m_termParser(termParser())
 {
 }
 
@@ -69,17 +86,31 @@ QList<Entry*> EntrySearcher::search(const QString& searchString, const Group* ba
 QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
 {
     Q_ASSERT(baseGroup);
+    Tracing::Span span("EntrySearcher::search");
+
+    // Entries lacking a required tag are skipped without looking at their fields
+    const auto tagged = taggedEntries(baseGroup);
+    auto hasRequiredTags = [&tagged](Entry* entry) {
+        for (const auto& entries : tagged) {
+            if (!entries.contains(entry)) {
+                return false;
+            }
+        }
+        return true;
+    };
 
     QList<Entry*> results;
     for (const auto group : baseGroup->groupsRecursive(true)) {
         if (forceSearch || group->resolveSearchingEnabled()) {
             for (const auto entry : group->entries()) {
-                if (searchEntryImpl(entry)) {
+                if (hasRequiredTags(entry) && searchEntryImpl(entry)) {
                     results.append(entry);
                 }
             }
         }
     }
+    span.setArg("terms", m_searchTerms.size());
+    span.setArg("results", results.size());
     return results;
 }
 
@@ -118,12 +149,17 @@ QList<Entry*> EntrySearcher::searchEntries(const QString& searchString, const QL
  */
 QList<Entry*> EntrySearcher::repeatEntries(const QList<Entry*>& entries)
 {
+    Tracing::Span span("EntrySearcher::searchEntries");
+
     QList<Entry*> results;
     for (auto* entry : entries) {
         if (searchEntryImpl(entry)) {
             results.append(entry);
         }
     }
+    span.setArg("terms", m_searchTerms.size());
+    span.setArg("entries", entries.size());
+    span.setArg("results", results.size());
     return results;
 }
 
@@ -144,63 +180,60 @@ bool EntrySearcher::isCaseSensitive() const
 
 bool EntrySearcher::searchEntryImpl(const Entry* entry)
 {
-    // Pre-load in case they are needed
-    auto attributes_keys = entry->attributes()->customKeys();
-    auto attributes = QStringList(attributes_keys + entry->attributes()->values(attributes_keys));
-    auto attachments = QStringList(entry->attachments()->keys());
-    // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
-    auto hierarchy = entry->group()->hierarchy().join('/').prepend("/");
-
     // By default, empty term matches every entry.
     // However when skipping protected fields, we will recject everything instead
     bool found = !m_skipProtected;
     for (const auto& term : m_searchTerms) {
         switch (term.field) {
         case Field::Title:
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch();
+            found = matchesField(term, entry, Entry::FoldedField::Title);
             break;
         case Field::Username:
-            found = term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch();
+            found = matchesField(term, entry, Entry::FoldedField::Username);
             break;
         case Field::Password:
             if (m_skipProtected) {
                 continue;
             }
-            found = term.regex.match(entry->resolvePlaceholder(entry->password())).hasMatch();
+            found = matches(term, entry->resolvePlaceholder(entry->password()));
             break;
         case Field::Url:
-            found = term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch();
+            found = matchesField(term, entry, Entry::FoldedField::Url);
             break;
         case Field::Notes:
-            found = term.regex.match(entry->notes()).hasMatch();
+            found = matches(term, entry->notes());
             break;
-        case Field::AttributeKV:
-            found = !attributes.filter(term.regex).empty();
+        case Field::AttributeKV: {
+            const auto keys = entry->attributes()->customKeys();
+            found = matchesAny(term, keys) || matchesAny(term, entry->attributes()->values(keys));
             break;
+        }
         case Field::Attachment:
-            found = !attachments.filter(term.regex).empty();
+            found = matchesAny(term, entry->attachments()->keys());
             break;
         case Field::AttributeValue:
             if (m_skipProtected && entry->attributes()->isProtected(term.word)) {
                 continue;
             }
-            found = entry->attributes()->contains(term.word)
-                    && term.regex.match(entry->attributes()->value(term.word)).hasMatch();
+            found = entry->attributes()->contains(term.word) && matches(term, entry->attributes()->value(term.word));
+            break;
+        case Field::Tag:
+            found = matchesTags(term, entry);
             break;
         case Field::Group:
             // Match against the full hierarchy if the word contains a '/' otherwise just the group name
             if (term.word.contains('/')) {
-                found = term.regex.match(hierarchy).hasMatch();
+                // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
+                found = matches(term, entry->group()->hierarchy().join('/').prepend("/"));
             } else {
-                found = term.regex.match(entry->group()->name()).hasMatch();
+                found = matches(term, entry->group()->name());
             }
             break;
         default:
             // Terms without a specific field try to match title, username, url, and notes
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch()
-                    || term.regex.match(entry->notes()).hasMatch();
+            found = matchesField(term, entry, Entry::FoldedField::Title)
+                    || matchesField(term, entry, Entry::FoldedField::Username)
+                    || matchesField(term, entry, Entry::FoldedField::Url) || matches(term, entry->notes());
         }
 
         // negate the result if exclude:
@@ -229,7 +262,9 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
         {QStringLiteral("u"), Field::Username}, // u: stands for username rather than url
         {QStringLiteral("url"), Field::Url},
         {QStringLiteral("username"), Field::Username},
-        {QStringLiteral("group"), Field::Group}};
+        {QStringLiteral("group"), Field::Group},
+        {QStringLiteral("tag"), Field::Tag},
+        {QStringLiteral("tags"), Field::Tag}};
 
     m_searchTerms.clear();
     auto results = m_termParser.globalMatch(searchString);
@@ -254,6 +289,8 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
 
         // Convert term to regex
         term.regex = Tools::convertToRegex(term.word, !mods.contains("*"), mods.contains("+"), m_caseSensitive);
+        term.caseSensitivity = m_caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+        classifyTerm(term, !mods.contains("*"), mods.contains("+"));
 
         // Exclude modifier
         term.exclude = mods.contains("-") || mods.contains("!");
@@ -279,6 +316,148 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
             }
         }
 
+        // A tag without wildcards has to match a whole tag
+        if (term.field == Field::Tag && term.type == MatchType::Literal && term.text == term.word) {
+            term.type = MatchType::Exact;
+            term.regex = Tools::convertToRegex(term.word, !mods.contains("*"), true, m_caseSensitive);
+        }
+
         m_searchTerms.append(term);
     }
 }
+
+/**
+ * Use plain string matching for terms whose wildcards can only appear at
+ * the start or end, the regex is kept for everything else.
+ */
+void EntrySearcher::classifyTerm(SearchTerm& term, bool useWildcards, bool exactMatch)
+{
+    term.type = MatchType::Regex;
+    term.text.clear();
+    term.foldedText.clear();
+    if (!useWildcards) {
+        return;
+    }
+
+    QString text = term.word;
+    bool anyStart = false;
+    bool anyEnd = false;
+    while (text.startsWith('*')) {
+        text.remove(0, 1);
+        anyStart = true;
+    }
+    while (text.endsWith('*')) {
+        text.chop(1);
+        anyEnd = true;
+    }
+    if (text.contains('*') || text.contains('?') || text.contains('|')) {
+        return;
+    }
+
+    term.text = text;
+    if (term.caseSensitivity == Qt::CaseInsensitive) {
+        term.foldedText = Entry::foldString(text);
+    }
+    if (!exactMatch || (anyStart && anyEnd)) {
+        term.type = MatchType::Literal;
+    } else if (anyEnd) {
+        term.type = MatchType::Prefix;
+    } else if (anyStart) {
+        term.type = MatchType::Suffix;
+    } else {
+        term.type = MatchType::Exact;
+    }
+}
+
+bool EntrySearcher::matches(const SearchTerm& term, const QString& value)
+{
+    if (term.type == MatchType::Regex) {
+        return term.regex.match(value).hasMatch();
+    }
+    return matchesText(term.type, term.text, value, term.caseSensitivity);
+}
+
+bool EntrySearcher::matchesText(MatchType type, const QString& text, const QString& value, Qt::CaseSensitivity cs)
+{
+    switch (type) {
+    case MatchType::Literal:
+        return text.isEmpty() || value.contains(text, cs);
+    case MatchType::Prefix:
+        return value.startsWith(text, cs);
+    case MatchType::Suffix:
+        return value.endsWith(text, cs);
+    case MatchType::Exact:
+        return value.compare(text, cs) == 0;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Match a title, username or url. Case insensitive plain terms compare the
+ * folded copies the entry keeps, unless the field contains a placeholder.
+ */
+bool EntrySearcher::matchesField(const SearchTerm& term, const Entry* entry, Entry::FoldedField field)
+{
+    QString value;
+    switch (field) {
+    case Entry::FoldedField::Title:
+        value = entry->title();
+        break;
+    case Entry::FoldedField::Username:
+        value = entry->username();
+        break;
+    default:
+        value = entry->url();
+        break;
+    }
+
+    if (!term.foldedText.isNull() && term.type != MatchType::Regex && !value.contains('{')) {
+        return matchesText(term.type, term.foldedText, entry->foldedField(field), Qt::CaseSensitive);
+    }
+    return matches(term, entry->resolvePlaceholder(value));
+}
+
+bool EntrySearcher::matchesAny(const SearchTerm& term, const QStringList& values)
+{
+    for (const auto& value : values) {
+        if (matches(term, value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EntrySearcher::matchesTags(const SearchTerm& term, const Entry* entry)
+{
+    if (!term.foldedText.isNull() && term.type != MatchType::Regex) {
+        for (const auto& tag : TagIndex::splitTags(entry->foldedField(Entry::FoldedField::Tags))) {
+            if (matchesText(term.type, term.foldedText, tag, Qt::CaseSensitive)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return matchesAny(term, TagIndex::splitTags(entry->tags()));
+}
+
+/**
+ * Look up the entries of whole tag terms in the tag index of the database.
+ *
+ * @return for every such term the set of entries that can match it
+ */
+QList<QSet<Entry*>> EntrySearcher::taggedEntries(const Group* baseGroup) const
+{
+    QList<QSet<Entry*>> tagged;
+    const auto* db = baseGroup->database();
+    if (!db) {
+        return tagged;
+    }
+
+    for (const auto& term : m_searchTerms) {
+        if (term.field == Field::Tag && term.type == MatchType::Exact && !term.exclude) {
+            tagged.append(db->tagIndex()->entries(term.text));
+        }
+    }
+    return tagged;
+}
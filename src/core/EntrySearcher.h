@@ -20,10 +20,12 @@
 #define KEEPASSX_ENTRYSEARCHER_H
 
 #include <QRegularExpression>
+#include <QSet>
 #include <QString>
 
+#include "core/Entry.h"
+
 class Group;
-class Entry;
 
 class EntrySearcher
 {
@@ -39,7 +41,18 @@ public:
         AttributeKV,
         Attachment,
         AttributeValue,
-        Group
+        Group,
+        Tag
+    };
+
+    // How a term is matched, plain words avoid the regex engine
+    enum class MatchType
+    {
+        Regex,
+        Literal, // value contains text
+        Prefix, // value starts with text
+        Suffix, // value ends with text
+        Exact // value equals text
     };
 
     struct SearchTerm
@@ -49,6 +62,12 @@ public:
         QString word;
         QRegularExpression regex;
         bool exclude;
+        // regex is used unless the parser found a simpler way to match the term
+        MatchType type = MatchType::Regex;
+        QString text;
+        Qt::CaseSensitivity caseSensitivity = Qt::CaseInsensitive;
+        // text as folded by Entry::foldString(), set for case insensitive non-regex terms
+        QString foldedText;
     };
 
     explicit EntrySearcher(bool caseSensitive = false, bool skipProtected = false);
@@ -67,6 +86,13 @@ public:
 private:
     bool searchEntryImpl(const Entry* entry);
     void parseSearchTerms(const QString& searchString);
+    static bool matches(const SearchTerm& term, const QString& value);
+    static bool matchesText(MatchType type, const QString& text, const QString& value, Qt::CaseSensitivity cs);
+    static bool matchesField(const SearchTerm& term, const Entry* entry, Entry::FoldedField field);
+    static bool matchesTags(const SearchTerm& term, const Entry* entry);
+    QList<QSet<Entry*>> taggedEntries(const Group* baseGroup) const;
+    static bool matchesAny(const SearchTerm& term, const QStringList& values);
+    static void classifyTerm(SearchTerm& term, bool useWildcards, bool exactMatch);
 
     bool m_caseSensitive;
     bool m_skipProtected;
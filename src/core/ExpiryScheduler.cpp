@@ -0,0 +1,185 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExpiryScheduler.h"
+
+#include "core/Clock.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+
+#include <QPointer>
+#include <QSet>
+
+#include <algorithm>
+
+namespace
+{
+    // Long waits are split up, this also catches up with changes of the system clock
+    constexpr qint64 MaxTimerInterval = 60 * 60 * 1000;
+    // Stale heap items are only dropped from the top, rebuild the heap once they pile up
+    constexpr int CompactThreshold = 64;
+
+    /**
+     * @return expiry time of the entry or an invalid time if it does not expire in the future
+     */
+    QDateTime upcomingExpiry(const Entry* entry)
+    {
+        const TimeInfo& timeInfo = entry->timeInfo();
+        if (!timeInfo.expires() || !timeInfo.expiryTime().isValid()
+            || timeInfo.expiryTime() < Clock::currentDateTimeUtc()) {
+            return {};
+        }
+        return timeInfo.expiryTime();
+    }
+} // namespace
+
+ExpiryScheduler::ExpiryScheduler(QObject* parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &ExpiryScheduler::processExpired);
+}
+
+void ExpiryScheduler::addEntry(Entry* entry)
+{
+    updateEntry(entry);
+}
+
+void ExpiryScheduler::removeEntry(const Entry* entry)
+{
+    if (m_deadlines.remove(entry) > 0) {
+        discardStale();
+        scheduleTimer();
+    }
+}
+
+void ExpiryScheduler::updateEntry(Entry* entry)
+{
+    const QDateTime expiry = upcomingExpiry(entry);
+    if (m_deadlines.value(entry) == expiry) {
+        return;
+    }
+
+    m_deadlines.remove(entry);
+    if (expiry.isValid()) {
+        m_deadlines.insert(entry, expiry);
+        m_heap.append({expiry, entry});
+        std::push_heap(m_heap.begin(), m_heap.end(), isLater);
+    }
+
+    discardStale();
+    scheduleTimer();
+}
+
+void ExpiryScheduler::clear()
+{
+    m_heap.clear();
+    m_deadlines.clear();
+    m_timer.stop();
+}
+
+/**
+ * @return earliest expiry time of the scheduled entries or an invalid time if there is none
+ */
+QDateTime ExpiryScheduler::nextExpiry() const
+{
+    return m_heap.isEmpty() ? QDateTime() : m_heap.first().time;
+}
+
+int ExpiryScheduler::scheduledCount() const
+{
+    return m_deadlines.size();
+}
+
+/**
+ * Report all scheduled entries whose expiry time has passed.
+ * Runs from the timer, calling it directly is only needed after changing the clock.
+ */
+void ExpiryScheduler::processExpired()
+{
+    const QDateTime now = Clock::currentDateTimeUtc();
+
+    // Finish with the heap before emitting, receivers may change entries
+    QList<QPointer<Entry>> expired;
+    while (!m_heap.isEmpty()) {
+        const Deadline& top = m_heap.first();
+        if (isCurrent(top)) {
+            if (!(top.time < now)) {
+                break;
+            }
+            expired.append(top.entry);
+            m_deadlines.remove(top.entry);
+        }
+        std::pop_heap(m_heap.begin(), m_heap.end(), isLater);
+        m_heap.removeLast();
+    }
+    scheduleTimer();
+
+    for (const auto& entry : asConst(expired)) {
+        if (entry) {
+            emit entryExpired(entry);
+        }
+    }
+}
+
+bool ExpiryScheduler::isCurrent(const Deadline& deadline) const
+{
+    const auto it = m_deadlines.constFind(deadline.entry);
+    return it != m_deadlines.constEnd() && it.value() == deadline.time;
+}
+
+bool ExpiryScheduler::isLater(const Deadline& lhs, const Deadline& rhs)
+{
+    return lhs.time > rhs.time;
+}
+
+void ExpiryScheduler::discardStale()
+{
+    if (m_heap.size() > 2 * m_deadlines.size() + CompactThreshold) {
+        // An entry removed and added again with the same expiry time has two current items
+        QVector<Deadline> current;
+        current.reserve(m_deadlines.size());
+        QSet<const Entry*> seen;
+        for (const Deadline& deadline : asConst(m_heap)) {
+            if (isCurrent(deadline) && !seen.contains(deadline.entry)) {
+                seen.insert(deadline.entry);
+                current.append(deadline);
+            }
+        }
+        m_heap.swap(current);
+        std::make_heap(m_heap.begin(), m_heap.end(), isLater);
+        return;
+    }
+
+    // Keep a current deadline at the top, so nextExpiry() and the timer are exact
+    while (!m_heap.isEmpty() && !isCurrent(m_heap.first())) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), isLater);
+        m_heap.removeLast();
+    }
+}
+
+void ExpiryScheduler::scheduleTimer()
+{
+    if (m_heap.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    // Entries expire once the current time is past the expiry time
+    const qint64 wait = Clock::currentDateTimeUtc().msecsTo(m_heap.first().time) + 1;
+    m_timer.start(static_cast<int>(qBound<qint64>(0, wait, MaxTimerInterval)));
+}
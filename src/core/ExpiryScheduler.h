@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_EXPIRYSCHEDULER_H
+#define KEEPASSXC_EXPIRYSCHEDULER_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+class Entry;
+
+/**
+ * Upcoming expiry times of the entries of a database.
+ *
+ * The deadlines are kept in a min-heap and a single timer is armed for the
+ * earliest one, so nothing has to scan the entries to notice that one of
+ * them expired. The entryExpired() signal is emitted once an entry passes
+ * its expiry time while it is scheduled; entries that are already expired
+ * when added are not reported.
+ */
+class ExpiryScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ExpiryScheduler(QObject* parent = nullptr);
+
+    void addEntry(Entry* entry);
+    void removeEntry(const Entry* entry);
+    void updateEntry(Entry* entry);
+    void clear();
+
+    QDateTime nextExpiry() const;
+    int scheduledCount() const;
+
+signals:
+    void entryExpired(Entry* entry);
+
+public slots:
+    void processExpired();
+
+private:
+    struct Deadline
+    {
+        QDateTime time;
+        Entry* entry;
+    };
+
+    static bool isLater(const Deadline& lhs, const Deadline& rhs);
+    bool isCurrent(const Deadline& deadline) const;
+    void discardStale();
+    void scheduleTimer();
+
+    // Heap items of removed or rescheduled entries are dropped lazily
+    QVector<Deadline> m_heap;
+    QHash<const Entry*, QDateTime> m_deadlines;
+    QTimer m_timer;
+};
+
+#endif // KEEPASSXC_EXPIRYSCHEDULER_H
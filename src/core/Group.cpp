@@ -363,12 +363,16 @@ void Group::setExpanded(bool expanded)
 
 void Group::setDefaultAutoTypeSequence(const QString& sequence)
 {
-    set(m_data.defaultAutoTypeSequence, sequence);
+    if (set(m_data.defaultAutoTypeSequence, sequence)) {
+        emit groupDataChanged(this);
+    }
 }
 
 void Group::setAutoTypeEnabled(TriState enable)
 {
-    set(m_data.autoTypeEnabled, enable);
+    if (set(m_data.autoTypeEnabled, enable)) {
+        emit groupDataChanged(this);
+    }
 }
 
 void Group::setSearchingEnabled(TriState enable)
@@ -580,6 +584,19 @@ Entry* Group::findEntryByUuid(const QUuid& uuid, bool recursive) const
         return nullptr;
     }
 
+    if (recursive && m_db) {
+        // The database index covers the whole tree, only accept hits below this group
+        Entry* entry = m_db->findEntryByUuid(uuid);
+        for (const Group* group = entry ? entry->group() : nullptr; group; group = group->parentGroup()) {
+            if (group == this) {
+                return entry;
+            }
+        }
+        if (m_db->rootGroup() == this) {
+            return nullptr;
+        }
+    }
+
     auto entries = m_entries;
     if (recursive) {
         entries = entriesRecursive(false);
@@ -615,6 +632,10 @@ Entry* Group::findEntryBySearchTerm(const QString& term, EntryReferenceType refe
                "Database::findEntryRecursive",
                "Can't search entry with \"referenceType\" parameter equal to \"Unknown\"");
 
+    if (referenceType == EntryReferenceType::QUuid) {
+        return findEntryByUuid(QUuid::fromRfc4122(QByteArray::fromHex(term.toLatin1())), true);
+    }
+
     const QList<Group*> groups = groupsRecursive(true);
 
     for (const Group* group : groups) {
@@ -910,6 +931,55 @@ Group* Group::clone(Entry::CloneFlags entryFlags, Group::CloneFlags groupFlags)
     return clonedGroup;
 }
 
+/**
+ * Move all entries and subgroups of this group into a new group outside of
+ * any database, e.g. to delete them in bulk. Listeners get one notification
+ * per group instead of one per entry, no deletion records are created.
+ *
+ * @return parentless group owning the former contents, the caller takes ownership
+ */
+Group* Group::takeContents()
+{
+    auto* contents = new Group();
+    contents->setUpdateTimeinfo(false);
+    if (m_entries.isEmpty() && m_children.isEmpty()) {
+        return contents;
+    }
+
+    const QList<Group*> groups = groupsRecursive(true);
+    for (Group* group : groups) {
+        emit group->entriesAboutToBeTaken(group);
+    }
+    const bool hasChildren = !m_children.isEmpty();
+    if (hasChildren) {
+        emit childrenAboutToBeTaken(this);
+    }
+
+    for (Entry* entry : asConst(m_entries)) {
+        entry->disconnect(this);
+        if (m_db) {
+            entry->disconnect(m_db);
+            emit m_db->entryAboutToRemove(entry);
+        }
+        entry->m_group = contents;
+        entry->QObject::setParent(contents);
+    }
+    contents->m_entries.swap(m_entries);
+
+    for (Group* child : asConst(m_children)) {
+        child->m_parent = contents;
+        child->connectDatabaseSignalsRecursive(nullptr);
+        child->QObject::setParent(contents);
+    }
+    contents->m_children.swap(m_children);
+
+    emitModified();
+    if (hasChildren) {
+        emit childrenTaken();
+    }
+    return contents;
+}
+
 void Group::copyDataFrom(const Group* other)
 {
     if (set(m_data, other->m_data)) {
@@ -929,7 +999,7 @@ void Group::addEntry(Entry* entry)
     m_entries << entry;
     connect(entry, &Entry::entryDataChanged, this, &Group::entryDataChanged);
     if (m_db) {
-        connect(entry, &Entry::modified, m_db, &Database::markAsModified);
+        connect(entry, &Entry::modified, m_db, &Database::markEntryAsModified);
     }
 
     emitModified();
@@ -948,7 +1018,7 @@ void Group::removeEntry(Entry* entry)
     if (m_db) {
         entry->disconnect(m_db);
     }
-    m_entries.removeAll(entry);
+    m_entries.removeOne(entry);
     emitModified();
     emit entryRemoved(entry);
 }
@@ -985,12 +1055,16 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
         disconnect(m_db);
     }
 
+    const bool databaseChanged = m_db != db;
     for (Entry* entry : asConst(m_entries)) {
         if (m_db) {
             entry->disconnect(m_db);
+            if (databaseChanged) {
+                emit m_db->entryAboutToRemove(entry);
+            }
         }
         if (db) {
-            connect(entry, &Entry::modified, db, &Database::markAsModified);
+            connect(entry, &Entry::modified, db, &Database::markEntryAsModified);
         }
     }
 
@@ -1003,13 +1077,24 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
         connect(this, &Group::groupAdded, db, &Database::groupAdded);
         connect(this, &Group::aboutToMove, db, &Database::groupAboutToMove);
         connect(this, &Group::groupMoved, db, &Database::groupMoved);
+        connect(this, &Group::childrenAboutToBeTaken, db, &Database::groupChildrenAboutToBeTaken);
+        connect(this, &Group::childrenTaken, db, &Database::groupChildrenTaken);
         connect(this, &Group::groupNonDataChange, db, &Database::markNonDataChange);
-        connect(this, &Group::modified, db, &Database::markAsModified);
+        connect(this, &Group::modified, db, &Database::markGroupAsModified);
+        connect(this, &Group::entryAdded, db, &Database::entryAdded);
+        connect(this, &Group::entryAboutToRemove, db, &Database::entryAboutToRemove);
+        connect(this, &Group::entryDataChanged, db, &Database::entryDataChanged);
         // clang-format on
     }
 
     m_db = db;
 
+    if (db && databaseChanged) {
+        for (Entry* entry : asConst(m_entries)) {
+            emit db->entryAdded(entry);
+        }
+    }
+
     for (Group* group : asConst(m_children)) {
         group->connectDatabaseSignalsRecursive(db);
     }
@@ -1019,7 +1104,7 @@ void Group::cleanupParent()
 {
     if (m_parent) {
         emit groupAboutToRemove(this);
-        m_parent->m_children.removeAll(this);
+        m_parent->m_children.removeOne(this);
         emitModified();
         emit groupRemoved();
     }
@@ -160,6 +160,7 @@ public:
 
     Group* clone(Entry::CloneFlags entryFlags = Entry::CloneDefault,
                  Group::CloneFlags groupFlags = Group::CloneDefault) const;
+    Group* takeContents();
 
     void copyDataFrom(const Group* other);
     QString print(bool recursive = false, bool flatten = false, int depth = 0);
@@ -195,6 +196,9 @@ signals:
     void entryAboutToMoveDown(int row);
     void entryMovedDown();
     void entryDataChanged(Entry* entry);
+    void entriesAboutToBeTaken(Group* group);
+    void childrenAboutToBeTaken(Group* group);
+    void childrenTaken();
 
 private slots:
     void updateTimeinfo();
@@ -21,6 +21,7 @@
 #include "core/Database.h"
 #include "core/Entry.h"
 #include "core/Metadata.h"
+#include "core/Tracing.h"
 
 Merger::Merger(const Database* sourceDb, Database* targetDb)
     : m_mode(Group::Default)
@@ -62,6 +63,7 @@ void Merger::resetForcedMergeMode()
 
 QStringList Merger::merge()
 {
+    Tracing::Span span("Merger::merge");
     // Order of merge steps is important - it is possible that we
     // create some items before deleting them afterwards
     ChangeList changes;
@@ -75,6 +77,7 @@ QStringList Merger::merge()
     if (!changes.isEmpty()) {
         m_context.m_targetDb->markAsModified();
     }
+    span.setArg("changes", changes.size());
     return changes;
 }
 
@@ -231,8 +234,8 @@ void Merger::moveGroup(Group* group, Group* targetGroup)
 void Merger::eraseEntry(Entry* entry)
 {
     Database* database = entry->database();
-    // most simple method to remove an item from DeletedObjects :(
-    const QList<DeletedObject> deletions = database->deletedObjects();
+    // Erasing is not a deletion, drop the records added while deleting
+    const int deletedObjectCount = database->deletedObjects().size();
     Group* parentGroup = entry->group();
     const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
     if (parentGroup) {
@@ -242,14 +245,14 @@ void Merger::eraseEntry(Entry* entry)
     if (parentGroup) {
         parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
     }
-    database->setDeletedObjects(deletions);
+    database->truncateDeletedObjects(deletedObjectCount);
 }
 
 void Merger::eraseGroup(Group* group)
 {
     Database* database = group->database();
-    // most simple method to remove an item from DeletedObjects :(
-    const QList<DeletedObject> deletions = database->deletedObjects();
+    // Erasing is not a deletion, drop the records added while deleting
+    const int deletedObjectCount = database->deletedObjects().size();
     Group* parentGroup = group->parentGroup();
     const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
     if (parentGroup) {
@@ -259,7 +262,7 @@ void Merger::eraseGroup(Group* group)
     if (parentGroup) {
         parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
     }
-    database->setDeletedObjects(deletions);
+    database->truncateDeletedObjects(deletedObjectCount);
 }
 
 Merger::ChangeList
@@ -416,36 +419,36 @@ bool Merger::mergeHistory(const Entry* sourceEntry, Entry* targetEntry, Group::M
     const bool preferLocal = mergeMethod == Group::KeepLocal || comparison < 0;
     const bool preferRemote = mergeMethod == Group::KeepRemote || comparison > 0;
 
-    QMap<QDateTime, Entry*> merged;
-    for (Entry* historyItem : targetHistoryItems) {
+    // Only the merge plan is built here; nothing is cloned until we know the history actually changes.
+    // History items are compared without their own history so live entries compare like their clones.
+    const CompareItemOptions compareOptions = CompareItemIgnoreMilliseconds | CompareItemIgnoreHistory;
+    QMap<QDateTime, const Entry*> merged;
+    for (const Entry* historyItem : targetHistoryItems) {
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
-        if (merged.contains(modificationTime)
-            && !merged[modificationTime]->equals(historyItem, CompareItemIgnoreMilliseconds)) {
+        const Entry* existing = merged.value(modificationTime);
+        if (existing && !existing->equals(historyItem, compareOptions)) {
             ::qWarning("Inconsistent history entry of %s[%s] at %s contains conflicting changes - conflict resolution "
                        "may lose data!",
                        qPrintable(sourceEntry->title()),
                        qPrintable(sourceEntry->uuidToHex()),
                        qPrintable(modificationTime.toString("yyyy-MM-dd HH-mm-ss-zzz")));
         }
-        merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
+        merged[modificationTime] = historyItem;
     }
-    for (Entry* historyItem : sourceHistoryItems) {
+    for (const Entry* historyItem : sourceHistoryItems) {
         // Items with same modification-time changes will be regarded as same (like KeePass2)
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
-        if (merged.contains(modificationTime)
-            && !merged[modificationTime]->equals(historyItem, CompareItemIgnoreMilliseconds)) {
+        const Entry* existing = merged.value(modificationTime);
+        if (existing && !existing->equals(historyItem, compareOptions)) {
             ::qWarning(
                 "History entry of %s[%s] at %s contains conflicting changes - conflict resolution may lose data!",
                 qPrintable(sourceEntry->title()),
                 qPrintable(sourceEntry->uuidToHex()),
                 qPrintable(modificationTime.toString("yyyy-MM-dd HH-mm-ss-zzz")));
         }
-        if (preferRemote && merged.contains(modificationTime)) {
+        if (!existing || preferRemote) {
             // forcefully apply the remote history item
-            delete merged.take(modificationTime);
-        }
-        if (!merged.contains(modificationTime)) {
-            merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
+            merged[modificationTime] = historyItem;
         }
     }
 
@@ -460,20 +463,13 @@ bool Merger::mergeHistory(const Entry* sourceEntry, Entry* targetEntry, Group::M
     }
 
     if (targetModificationTime < sourceModificationTime) {
-        if (preferLocal && merged.contains(targetModificationTime)) {
+        if (preferLocal || !merged.contains(targetModificationTime)) {
             // forcefully apply the local history item
-            delete merged.take(targetModificationTime);
-        }
-        if (!merged.contains(targetModificationTime)) {
-            merged[targetModificationTime] = targetEntry->clone(Entry::CloneNoFlags);
+            merged[targetModificationTime] = targetEntry;
         }
     } else if (targetModificationTime > sourceModificationTime) {
-        if (preferRemote && !merged.contains(sourceModificationTime)) {
-            // forcefully apply the remote history item
-            delete merged.take(sourceModificationTime);
-        }
         if (!merged.contains(sourceModificationTime)) {
-            merged[sourceModificationTime] = sourceEntry->clone(Entry::CloneNoFlags);
+            merged[sourceModificationTime] = sourceEntry;
         }
     }
 
@@ -483,30 +479,53 @@ bool Merger::mergeHistory(const Entry* sourceEntry, Entry* targetEntry, Group::M
     for (int i = 0; i < maxItems; ++i) {
         const Entry* oldEntry = targetHistoryItems.value(targetHistoryItems.count() - i);
         const Entry* newEntry = updatedHistoryItems.value(updatedHistoryItems.count() - i);
-        if (!oldEntry && !newEntry) {
+        if (oldEntry == newEntry) {
+            // Unchanged item of the target history (or both missing)
             continue;
         }
-        if (oldEntry && newEntry && oldEntry->equals(newEntry, CompareItemIgnoreMilliseconds)) {
+        if (oldEntry && newEntry && oldEntry->equals(newEntry, compareOptions)) {
             continue;
         }
         changed = true;
         break;
     }
     if (!changed) {
-        qDeleteAll(updatedHistoryItems);
         return false;
     }
+
+    // Reuse the target history items that survive the merge and only clone the missing ones
+    QSet<const Entry*> targetItems;
+    for (const Entry* historyItem : targetHistoryItems) {
+        targetItems.insert(historyItem);
+    }
+    QSet<const Entry*> keptItems;
+    QList<Entry*> missingItems;
+    for (const Entry* historyItem : updatedHistoryItems) {
+        if (targetItems.contains(historyItem)) {
+            keptItems.insert(historyItem);
+        } else {
+            missingItems.append(historyItem->clone(Entry::CloneNoFlags));
+        }
+    }
+    QList<Entry*> droppedItems;
+    for (Entry* historyItem : targetHistoryItems) {
+        if (!keptItems.contains(historyItem)) {
+            droppedItems.append(historyItem);
+        }
+    }
+
     // We need to prevent any modification to the database since every change should be tracked either
     // in a clone history item or in the Entry itself
     const TimeInfo timeInfo = targetEntry->timeInfo();
     const bool blockedSignals = targetEntry->blockSignals(true);
     bool updateTimeInfo = targetEntry->canUpdateTimeinfo();
     targetEntry->setUpdateTimeinfo(false);
-    targetEntry->removeHistoryItems(targetHistoryItems);
-    for (Entry* historyItem : merged) {
+    targetEntry->removeHistoryItems(droppedItems);
+    for (Entry* historyItem : missingItems) {
         Q_ASSERT(!historyItem->parent());
         targetEntry->addHistoryItem(historyItem);
     }
+    targetEntry->sortHistory();
     targetEntry->truncateHistory();
     targetEntry->blockSignals(blockedSignals);
     targetEntry->setUpdateTimeinfo(updateTimeInfo);
@@ -528,20 +547,32 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
     const auto sourceDeletions = context.m_sourceDb->deletedObjects();
 
     QList<DeletedObject> deletions;
-    QMap<QUuid, DeletedObject> mergedDeletions;
+    QHash<QUuid, DeletedObject> mergedDeletions;
     QList<Entry*> entries;
     QList<Group*> groups;
 
+    // Index the target tree once instead of searching it for every deletion record
+    QHash<QUuid, Entry*> targetEntries;
+    for (Entry* entry : context.m_targetRootGroup->entriesRecursive(false)) {
+        targetEntries.insert(entry->uuid(), entry);
+    }
+    QHash<QUuid, Group*> targetGroups;
+    for (Group* group : context.m_targetRootGroup->groupsRecursive(true)) {
+        targetGroups.insert(group->uuid(), group);
+    }
+
+    mergedDeletions.reserve(targetDeletions.size() + sourceDeletions.size());
     for (const auto& object : (targetDeletions + sourceDeletions)) {
-        if (!mergedDeletions.contains(object.uuid)) {
-            mergedDeletions[object.uuid] = object;
+        auto merged = mergedDeletions.find(object.uuid);
+        if (merged == mergedDeletions.end()) {
+            mergedDeletions.insert(object.uuid, object);
 
-            auto* entry = context.m_targetRootGroup->findEntryByUuid(object.uuid);
+            auto* entry = targetEntries.value(object.uuid);
             if (entry) {
                 entries << entry;
                 continue;
             }
-            auto* group = context.m_targetRootGroup->findGroupByUuid(object.uuid);
+            auto* group = targetGroups.value(object.uuid);
             if (group) {
                 groups << group;
                 continue;
@@ -549,8 +580,8 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
             deletions << object;
             continue;
         }
-        if (mergedDeletions[object.uuid].deletionTime > object.deletionTime) {
-            mergedDeletions[object.uuid] = object;
+        if (merged->deletionTime > object.deletionTime) {
+            *merged = object;
         }
     }
 
@@ -614,8 +645,7 @@ Merger::ChangeList Merger::mergeMetadata(const MergeContext& context)
 
     for (const auto& iconUuid : sourceMetadata->customIconsOrder()) {
         if (!targetMetadata->hasCustomIcon(iconUuid)) {
-            QImage customIcon = sourceMetadata->customIcon(iconUuid);
-            targetMetadata->addCustomIcon(iconUuid, customIcon);
+            targetMetadata->addCustomIcon(iconUuid, sourceMetadata->customIconData(iconUuid));
             changes << tr("Adding missing icon %1").arg(QString::fromLatin1(iconUuid.toRfc4122().toHex()));
         }
     }
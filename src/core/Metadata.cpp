@@ -17,6 +17,7 @@
 
 #include "Metadata.h"
 #include <QApplication>
+#include <QBuffer>
 #include <QtCore/QCryptographicHash>
 
 #include "core/Clock.h"
@@ -27,6 +28,7 @@
 
 const int Metadata::DefaultHistoryMaxItems = 10;
 const int Metadata::DefaultHistoryMaxSize = 6 * 1024 * 1024;
+const int Metadata::MaxCustomIconSize = 128;
 
 Metadata::Metadata(QObject* parent)
     : ModifiableObject(parent)
@@ -69,6 +71,8 @@ void Metadata::clear()
     m_customIconsRaw.clear();
     m_customIconsOrder.clear();
     m_customIconsHashes.clear();
+    m_customIconsHashByUuid.clear();
+    m_customIconsEncoded.clear();
     m_customData->clear();
 }
 
@@ -182,6 +186,28 @@ QImage Metadata::customIcon(const QUuid& uuid) const
     return m_customIconsRaw.value(uuid);
 }
 
+/**
+ * Encoding of a custom icon as stored in the database file. Icons loaded
+ * from encoded data keep it; others are encoded as PNG once and reused.
+ */
+QByteArray Metadata::customIconData(const QUuid& uuid) const
+{
+    auto it = m_customIconsEncoded.constFind(uuid);
+    if (it != m_customIconsEncoded.constEnd()) {
+        return it.value();
+    }
+    if (!m_customIconsRaw.contains(uuid)) {
+        return {};
+    }
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    m_customIconsRaw.value(uuid).save(&buffer, "PNG");
+    m_customIconsEncoded.insert(uuid, data);
+    return data;
+}
+
 QPixmap Metadata::customIconPixmap(const QUuid& uuid, IconSize size) const
 {
     if (!hasCustomIcon(uuid)) {
@@ -359,18 +385,26 @@ void Metadata::setProtectNotes(bool value)
     set(m_data.protectNotes, value);
 }
 
+/**
+ * Add a custom icon as it is. Icons added by the user should be passed
+ * through normalizeCustomIcon() first.
+ */
 void Metadata::addCustomIcon(const QUuid& uuid, const QImage& image)
 {
     Q_ASSERT(!uuid.isNull());
     Q_ASSERT(!m_customIconsRaw.contains(uuid));
 
     m_customIconsRaw[uuid] = image;
+    m_customIconsEncoded.remove(uuid);
     // remove all uuids to prevent duplicates in release mode
     m_customIconsOrder.removeAll(uuid);
     m_customIconsOrder.append(uuid);
-    // Associate image hash to uuid
+    // Associate image hash to uuid, the first icon with a given hash stays in the index
     QByteArray hash = hashImage(image);
-    m_customIconsHashes[hash] = uuid;
+    m_customIconsHashByUuid[uuid] = hash;
+    if (!m_customIconsHashes.contains(hash)) {
+        m_customIconsHashes[hash] = uuid;
+    }
     Q_ASSERT(m_customIconsRaw.count() == m_customIconsOrder.count());
 
     // TODO: This check can go away when we move all QIcon handling outside of core
@@ -379,7 +413,8 @@ void Metadata::addCustomIcon(const QUuid& uuid, const QImage& image)
     static bool isGui = qApp->inherits("QGuiApplication");
     if (isGui) {
         // Generate QIcon with pre-baked resolutions
-        auto basePixmap = QPixmap::fromImage(image.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+        auto basePixmap =
+            QPixmap::fromImage(image.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
         QIcon icon(basePixmap);
         m_customIcons.insert(uuid, icon);
     } else {
@@ -389,48 +424,117 @@ void Metadata::addCustomIcon(const QUuid& uuid, const QImage& image)
     emitModified();
 }
 
+/**
+ * Add a custom icon from its encoded form, which is saved back unchanged.
+ */
+void Metadata::addCustomIcon(const QUuid& uuid, const QByteArray& iconData)
+{
+    addCustomIcon(uuid, QImage::fromData(iconData));
+    m_customIconsEncoded.insert(uuid, iconData);
+}
+
 void Metadata::removeCustomIcon(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
     Q_ASSERT(m_customIconsRaw.contains(uuid));
 
-    // Remove hash record only if this is the same uuid
-    QByteArray hash = hashImage(m_customIconsRaw[uuid]);
-    if (m_customIconsHashes.contains(hash) && m_customIconsHashes[hash] == uuid) {
-        m_customIconsHashes.remove(hash);
-    }
-
     m_customIcons.remove(uuid);
     m_customIconsRaw.remove(uuid);
+    m_customIconsEncoded.remove(uuid);
     m_customIconsOrder.removeAll(uuid);
+
+    // Remove hash record only if this is the same uuid, a remaining duplicate takes its place
+    const QByteArray hash = m_customIconsHashByUuid.take(uuid);
+    if (m_customIconsHashes.value(hash) == uuid) {
+        m_customIconsHashes.remove(hash);
+        for (const QUuid& other : asConst(m_customIconsOrder)) {
+            if (m_customIconsHashByUuid.value(other) == hash) {
+                m_customIconsHashes.insert(hash, other);
+                break;
+            }
+        }
+    }
     Q_ASSERT(m_customIconsRaw.count() == m_customIconsOrder.count());
     emitModified();
 }
 
+/**
+ * Find a custom icon showing the same picture as the candidate, even if the
+ * stored icon has a different pixel format or is the normalized candidate.
+ */
 QUuid Metadata::findCustomIcon(const QImage& candidate)
 {
+    if (candidate.isNull()) {
+        return {};
+    }
     QByteArray hash = hashImage(candidate);
     return m_customIconsHashes.value(hash, QUuid());
 }
 
+/**
+ * Map every custom icon that duplicates an earlier icon to the uuid of the
+ * first icon with the same picture.
+ */
+QHash<QUuid, QUuid> Metadata::duplicateCustomIcons() const
+{
+    QHash<QUuid, QUuid> duplicates;
+    for (const QUuid& uuid : m_customIconsOrder) {
+        const QUuid original = m_customIconsHashes.value(m_customIconsHashByUuid.value(uuid));
+        if (!original.isNull() && original != uuid) {
+            duplicates.insert(uuid, original);
+        }
+    }
+    return duplicates;
+}
+
+/**
+ * Bring an icon into the form it is stored in: at most MaxCustomIconSize
+ * pixels wide and high, in a 32-bit RGB format.
+ */
+QImage Metadata::normalizeCustomIcon(const QImage& image)
+{
+    QImage result = image;
+    if (result.width() > MaxCustomIconSize || result.height() > MaxCustomIconSize) {
+        result = result.scaled(MaxCustomIconSize, MaxCustomIconSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    if (!result.isNull() && result.format() != QImage::Format_RGB32 && result.format() != QImage::Format_ARGB32) {
+        result = result.convertToFormat(result.hasAlphaChannel() ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+    }
+    return result;
+}
+
 void Metadata::copyCustomIcons(const QSet<QUuid>& iconList, const Metadata* otherMetadata)
 {
     for (const QUuid& uuid : iconList) {
         Q_ASSERT(otherMetadata->hasCustomIcon(uuid));
 
         if (!hasCustomIcon(uuid) && otherMetadata->hasCustomIcon(uuid)) {
-            addCustomIcon(uuid, otherMetadata->customIcon(uuid));
+            addCustomIcon(uuid, otherMetadata->customIconData(uuid));
         }
     }
 }
 
+/**
+ * Hash the picture of an icon independent of its pixel format.
+ * The icon is normalized first, so an icon larger than the stored size
+ * hashes like the copy of it that is stored. Fully transparent pixels
+ * hash the same whatever their color.
+ */
 QByteArray Metadata::hashImage(const QImage& image)
 {
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-    auto data = QByteArray(reinterpret_cast<const char*>(image.bits()), static_cast<int>(image.sizeInBytes()));
-#else
-    auto data = QByteArray(reinterpret_cast<const char*>(image.bits()), image.byteCount());
-#endif
+    const QImage normalized = normalizeCustomIcon(image).convertToFormat(QImage::Format_ARGB32);
+
+    QByteArray data;
+    data.reserve(normalized.width() * normalized.height() * 4 + 8);
+    const qint32 size[] = {normalized.width(), normalized.height()};
+    data.append(reinterpret_cast<const char*>(size), sizeof(size));
+    for (int y = 0; y < normalized.height(); ++y) {
+        const auto* line = reinterpret_cast<const QRgb*>(normalized.constScanLine(y));
+        for (int x = 0; x < normalized.width(); ++x) {
+            const QRgb pixel = qAlpha(line[x]) == 0 ? 0 : line[x];
+            data.append(reinterpret_cast<const char*>(&pixel), sizeof(pixel));
+        }
+    }
     return QCryptographicHash::hash(data, QCryptographicHash::Md5);
 }
 
@@ -85,6 +85,7 @@ public:
     bool protectUrl() const;
     bool protectNotes() const;
     QImage customIcon(const QUuid& uuid) const;
+    QByteArray customIconData(const QUuid& uuid) const;
     bool hasCustomIcon(const QUuid& uuid) const;
     QPixmap customIconPixmap(const QUuid& uuid, IconSize size = IconSize::Default) const;
     QHash<QUuid, QPixmap> customIconsPixmaps(IconSize size = IconSize::Default) const;
@@ -107,6 +108,7 @@ public:
 
     static const int DefaultHistoryMaxItems;
     static const int DefaultHistoryMaxSize;
+    static const int MaxCustomIconSize;
 
     void setGenerator(const QString& value);
     void setName(const QString& value);
@@ -124,9 +126,12 @@ public:
     void setProtectUrl(bool value);
     void setProtectNotes(bool value);
     void addCustomIcon(const QUuid& uuid, const QImage& image);
+    void addCustomIcon(const QUuid& uuid, const QByteArray& iconData);
     void removeCustomIcon(const QUuid& uuid);
     void copyCustomIcons(const QSet<QUuid>& iconList, const Metadata* otherMetadata);
     QUuid findCustomIcon(const QImage& candidate);
+    QHash<QUuid, QUuid> duplicateCustomIcons() const;
+    static QImage normalizeCustomIcon(const QImage& image);
     void setRecycleBinEnabled(bool value);
     void setRecycleBin(Group* group);
     void setRecycleBinChanged(const QDateTime& value);
@@ -154,7 +159,7 @@ private:
     template <class P, class V> bool set(P& property, const V& value);
     template <class P, class V> bool set(P& property, const V& value, QDateTime& dateTime);
 
-    QByteArray hashImage(const QImage& image);
+    static QByteArray hashImage(const QImage& image);
 
     MetadataData m_data;
 
@@ -162,6 +167,8 @@ private:
     QHash<QUuid, QImage> m_customIconsRaw;
     QList<QUuid> m_customIconsOrder;
     QHash<QByteArray, QUuid> m_customIconsHashes;
+    QHash<QUuid, QByteArray> m_customIconsHashByUuid;
+    mutable QHash<QUuid, QByteArray> m_customIconsEncoded;
 
     QPointer<Group> m_recycleBin;
     QDateTime m_recycleBinChanged;
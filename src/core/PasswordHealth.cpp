@@ -130,11 +130,8 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
     const auto& used = m_reuse[pwd];
-    const auto count = used.size();
-    if (count > 1) {
-        constexpr auto penalty = 15;
-        health->adjustScore(-penalty * (count - 1));
-        health->addScoreReason(QObject::tr("Password is used %1 time(s)", "", count).arg(QString::number(count)));
+    adjustForReuse(health.data(), used.size());
+    if (used.size() > 1) {
         // Add the first 20 uses of the password to prevent the details display from growing too large
         for (int i = 0; i < used.size(); ++i) {
             health->addScoreDetails(used[i]);
@@ -143,17 +140,39 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
                 break;
             }
         }
+    }
 
-        // Don't allow re-used passwords to be considered "good"
-        // no matter how great their entropy is.
-        if (health->score() > 64) {
-            health->setScore(64);
-        }
+    // Third, take the expiry of the password into account
+    adjustForExpiry(health.data(), entry);
+
+    // Return the result
+    return health;
+}
+
+void HealthChecker::adjustForReuse(PasswordHealth* health, int useCount)
+{
+    if (useCount <= 1) {
+        return;
+    }
+
+    constexpr auto penalty = 15;
+    health->adjustScore(-penalty * (useCount - 1));
+    health->addScoreReason(QObject::tr("Password is used %1 time(s)", "", useCount).arg(QString::number(useCount)));
+
+    // Don't allow re-used passwords to be considered "good"
+    // no matter how great their entropy is.
+    if (health->score() > 64) {
+        health->setScore(64);
     }
+}
 
-    // Third, if the password has already expired, reduce score to 0;
-    // or, if the password is going to expire in the next 30 days,
-    // reduce score by 2 points per day.
+/**
+ * If the password has already expired, reduce score to 0;
+ * or, if the password is going to expire in the next 30 days,
+ * reduce score by 2 points per day.
+ */
+void HealthChecker::adjustForExpiry(PasswordHealth* health, const Entry* entry)
+{
     if (entry->isExpired()) {
         health->setScore(0);
         health->addScoreReason(QObject::tr("Password has expired"));
@@ -183,7 +202,4 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
             }
         }
     }
-
-    // Return the result
-    return health;
 }
@@ -103,6 +103,11 @@ public:
     // Get the health status of an entry in the database
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
 
+    // Lower the score of a password used by more than one entry
+    static void adjustForReuse(PasswordHealth* health, int useCount);
+    // Lower the score of a password that has expired or expires soon
+    static void adjustForExpiry(PasswordHealth* health, const Entry* entry);
+
 private:
     // To determine password re-use: first = password, second = entries that use it
     QHash<QString, QStringList> m_reuse;
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SecureArena.h"
+
+#include <botan/mem_ops.h>
+
+#include <atomic>
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace
+{
+    std::atomic<std::size_t> g_mappedBytes(0);
+    std::atomic<std::size_t> g_scrubbedBytes(0);
+
+    std::size_t pageSize()
+    {
+        static const std::size_t size = []() -> std::size_t {
+#if defined(Q_OS_UNIX)
+            long result = sysconf(_SC_PAGESIZE);
+            return result > 0 ? static_cast<std::size_t>(result) : 4096;
+#elif defined(Q_OS_WIN)
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+#else
+            return 4096;
+#endif
+        }();
+        return size;
+    }
+
+    bool useMapping(std::size_t size)
+    {
+#if defined(Q_OS_UNIX) || defined(Q_OS_WIN)
+        // Anything smaller than a page is better served by Botan's locked pool
+        return size >= pageSize();
+#else
+        Q_UNUSED(size);
+        return false;
+#endif
+    }
+
+    std::size_t roundToPages(std::size_t size)
+    {
+        const std::size_t page = pageSize();
+        return ((size + page - 1) / page) * page;
+    }
+
+    /**
+     * Map the data pages with one inaccessible guard page on each side.
+     * Locking is best effort since it is subject to RLIMIT_MEMLOCK.
+     */
+    void* mapPages(std::size_t dataSize)
+    {
+        const std::size_t page = pageSize();
+        const std::size_t total = dataSize + 2 * page;
+#if defined(Q_OS_UNIX)
+        void* base = mmap(nullptr, total, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            return nullptr;
+        }
+        auto data = static_cast<char*>(base) + page;
+        if (mprotect(data, dataSize, PROT_READ | PROT_WRITE) != 0) {
+            munmap(base, total);
+            return nullptr;
+        }
+        mlock(data, dataSize);
+#ifdef MADV_DONTDUMP
+        madvise(data, dataSize, MADV_DONTDUMP);
+#endif
+        return data;
+#elif defined(Q_OS_WIN)
+        void* base = VirtualAlloc(nullptr, total, MEM_RESERVE, PAGE_NOACCESS);
+        if (!base) {
+            return nullptr;
+        }
+        auto data = static_cast<char*>(base) + page;
+        if (!VirtualAlloc(data, dataSize, MEM_COMMIT, PAGE_READWRITE)) {
+            VirtualFree(base, 0, MEM_RELEASE);
+            return nullptr;
+        }
+        VirtualLock(data, dataSize);
+        return data;
+#else
+        Q_UNUSED(total);
+        return nullptr;
+#endif
+    }
+
+    void unmapPages(void* data, std::size_t dataSize)
+    {
+        const std::size_t page = pageSize();
+        SecureArena::scrub(data, dataSize);
+        auto base = static_cast<char*>(data) - page;
+#if defined(Q_OS_UNIX)
+        munlock(data, dataSize);
+        munmap(base, dataSize + 2 * page);
+#elif defined(Q_OS_WIN)
+        VirtualUnlock(data, dataSize);
+        VirtualFree(base, 0, MEM_RELEASE);
+#else
+        Q_UNUSED(base);
+#endif
+    }
+} // namespace
+
+namespace SecureArena
+{
+    void* allocate(std::size_t size)
+    {
+        if (size == 0) {
+            size = 1;
+        }
+
+        if (!useMapping(size)) {
+            // Botan returns zeroed memory and throws std::bad_alloc on failure
+            return Botan::allocate_memory(size, 1);
+        }
+
+        const std::size_t dataSize = roundToPages(size);
+        void* data = mapPages(dataSize);
+        if (!data) {
+            throw std::bad_alloc();
+        }
+        g_mappedBytes += dataSize;
+        return data;
+    }
+
+    void deallocate(void* ptr, std::size_t size) noexcept
+    {
+        if (!ptr) {
+            return;
+        }
+        if (size == 0) {
+            size = 1;
+        }
+
+        if (!useMapping(size)) {
+            // Scrub here as well, so the memory is cleared however Botan releases it
+            scrub(ptr, size);
+            Botan::deallocate_memory(ptr, size, 1);
+            return;
+        }
+
+        const std::size_t dataSize = roundToPages(size);
+        unmapPages(ptr, dataSize);
+        g_mappedBytes -= dataSize;
+    }
+
+    /**
+     * Overwrite memory with zeros in a way the compiler cannot optimize away.
+     */
+    void scrub(void* ptr, std::size_t size) noexcept
+    {
+        Botan::secure_scrub_memory(ptr, size);
+        g_scrubbedBytes += size;
+    }
+
+    std::size_t mappedBytes()
+    {
+        return g_mappedBytes;
+    }
+
+    std::size_t scrubbedBytes()
+    {
+        return g_scrubbedBytes;
+    }
+} // namespace SecureArena
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_SECUREARENA_H
+#define KEEPASSXC_SECUREARENA_H
+
+#include <QtGlobal>
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+/**
+ * Allocator for secret material (keys, transformed keys, key file buffers).
+ *
+ * Small allocations are served from Botan's locked memory pool. Larger
+ * allocations get their own page-aligned mapping which is locked into RAM
+ * (never swapped), excluded from core dumps where supported and surrounded
+ * by inaccessible guard pages. All memory is scrubbed before it is released.
+ */
+namespace SecureArena
+{
+    void* allocate(std::size_t size);
+    void deallocate(void* ptr, std::size_t size) noexcept;
+    void scrub(void* ptr, std::size_t size) noexcept;
+
+    /**
+     * @return number of bytes currently held in guard-paged mappings
+     */
+    std::size_t mappedBytes();
+
+    /**
+     * @return number of bytes scrubbed on release since the start of the process
+     */
+    std::size_t scrubbedBytes();
+} // namespace SecureArena
+
+template <typename T> class SecureAllocator
+{
+public:
+    using value_type = T;
+
+    SecureAllocator() noexcept = default;
+    template <typename U> SecureAllocator(const SecureAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(SecureArena::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        SecureArena::deallocate(ptr, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U> bool operator==(const SecureAllocator<T>&, const SecureAllocator<U>&) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U> bool operator!=(const SecureAllocator<T>&, const SecureAllocator<U>&) noexcept
+{
+    return false;
+}
+
+template <typename T> using SecureVector = std::vector<T, SecureAllocator<T>>;
+
+#endif // KEEPASSXC_SECUREARENA_H
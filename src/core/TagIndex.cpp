@@ -0,0 +1,169 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TagIndex.h"
+
+#include "core/Entry.h"
+
+#include <QRegularExpression>
+
+void TagIndex::addEntry(Entry* entry)
+{
+    if (m_entryTags.contains(entry)) {
+        updateEntry(entry);
+        return;
+    }
+    const QString tags = entry->tags();
+    m_entryTags.insert(entry, tags);
+    insert(entry, tags);
+}
+
+void TagIndex::removeEntry(const Entry* entry)
+{
+    auto it = m_entryTags.find(entry);
+    if (it == m_entryTags.end()) {
+        return;
+    }
+    // Only the pointer is used, the entry may be partially destroyed already
+    remove(const_cast<Entry*>(entry), it.value());
+    m_entryTags.erase(it);
+}
+
+/**
+ * Reindex the tags of an entry that is already known
+ */
+void TagIndex::updateEntry(Entry* entry)
+{
+    auto it = m_entryTags.find(entry);
+    if (it == m_entryTags.end()) {
+        return;
+    }
+    const QString tags = entry->tags();
+    if (tags != it.value()) {
+        remove(entry, it.value());
+        insert(entry, tags);
+        it.value() = tags;
+    }
+}
+
+void TagIndex::clear()
+{
+    m_entryTags.clear();
+    m_tags.clear();
+}
+
+/**
+ * @return entries with the given tag
+ */
+QSet<Entry*> TagIndex::entries(const QString& tag) const
+{
+    return m_tags.value(Entry::foldString(tag.trimmed())).entries;
+}
+
+int TagIndex::count(const QString& tag) const
+{
+    auto it = m_tags.constFind(Entry::foldString(tag.trimmed()));
+    return it == m_tags.constEnd() ? 0 : it->entries.size();
+}
+
+/**
+ * @return all tags in use, sorted case insensitively
+ */
+QStringList TagIndex::tags() const
+{
+    QStringList tags;
+    tags.reserve(m_tags.size());
+    for (const auto& tag : m_tags) {
+        tags.append(tag.name);
+    }
+    return tags;
+}
+
+/**
+ * Tags starting with the given prefix, sorted case insensitively
+ *
+ * @param limit maximum number of tags, all matching tags if negative
+ */
+QStringList TagIndex::completions(const QString& prefix, int limit) const
+{
+    const QString folded = Entry::foldString(prefix.trimmed());
+
+    QStringList tags;
+    for (auto it = m_tags.lowerBound(folded); it != m_tags.constEnd() && it.key().startsWith(folded); ++it) {
+        if (limit >= 0 && tags.size() >= limit) {
+            break;
+        }
+        tags.append(it->name);
+    }
+    return tags;
+}
+
+/**
+ * @return number of entries per tag
+ */
+QMap<QString, int> TagIndex::tagCounts() const
+{
+    QMap<QString, int> counts;
+    for (const auto& tag : m_tags) {
+        counts.insert(tag.name, tag.entries.size());
+    }
+    return counts;
+}
+
+/**
+ * Split a tags field into its tags, separated by semicolons or commas
+ */
+QStringList TagIndex::splitTags(const QString& tags)
+{
+    static const QRegularExpression separator("[;,]");
+
+    QStringList result;
+    if (tags.isEmpty()) {
+        return result;
+    }
+    for (const auto& tag : tags.split(separator, QString::SkipEmptyParts)) {
+        const auto trimmed = tag.trimmed();
+        if (!trimmed.isEmpty() && !result.contains(trimmed)) {
+            result.append(trimmed);
+        }
+    }
+    return result;
+}
+
+void TagIndex::insert(Entry* entry, const QString& tags)
+{
+    for (const auto& name : splitTags(tags)) {
+        auto it = m_tags.find(Entry::foldString(name));
+        if (it == m_tags.end()) {
+            it = m_tags.insert(Entry::foldString(name), {name, {}});
+        }
+        it->entries.insert(entry);
+    }
+}
+
+void TagIndex::remove(Entry* entry, const QString& tags)
+{
+    for (const auto& name : splitTags(tags)) {
+        auto it = m_tags.find(Entry::foldString(name));
+        if (it != m_tags.end()) {
+            it->entries.remove(entry);
+            if (it->entries.isEmpty()) {
+                m_tags.erase(it);
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_TAGINDEX_H
+#define KEEPASSXC_TAGINDEX_H
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+
+class Entry;
+
+/**
+ * Entries of a database by tag, kept up to date as entries are added,
+ * removed or changed. Recycled entries are included.
+ *
+ * Tags are compared case insensitively after Entry::foldString(), the
+ * spelling of the first entry that used a tag is the one reported.
+ */
+class TagIndex
+{
+public:
+    void addEntry(Entry* entry);
+    void removeEntry(const Entry* entry);
+    void updateEntry(Entry* entry);
+    void clear();
+
+    QSet<Entry*> entries(const QString& tag) const;
+    int count(const QString& tag) const;
+    QStringList tags() const;
+    QStringList completions(const QString& prefix, int limit = -1) const;
+    QMap<QString, int> tagCounts() const;
+
+    static QStringList splitTags(const QString& tags);
+
+private:
+    struct Tag
+    {
+        QString name;
+        QSet<Entry*> entries;
+    };
+
+    void insert(Entry* entry, const QString& tags);
+    void remove(Entry* entry, const QString& tags);
+
+    // Raw tags string of every indexed entry
+    QHash<const Entry*, QString> m_entryTags;
+    // Sorted by folded tag, so completions are a range lookup
+    QMap<QString, Tag> m_tags;
+};
+
+#endif // KEEPASSXC_TAGINDEX_H
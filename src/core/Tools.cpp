@@ -24,11 +24,13 @@
 #include "core/Translator.h"
 
 #include "git-info.h"
+#include <QCache>
 #include <QCoreApplication>
 #include <QElapsedTimer>
 #include <QIODevice>
 #include <QImageReader>
 #include <QLocale>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QStringList>
 #include <QSysInfo>
@@ -292,8 +294,39 @@ namespace Tools
     // Escape common regex symbols except for *, ?, and |
     auto regexEscape = QRegularExpression(R"re(([-[\]{}()+.,\\\/^$#]))re");
 
+    namespace
+    {
+        // Number of compiled expressions kept by convertToRegex()
+        constexpr int RegexCacheSize = 512;
+
+        struct RegexCache
+        {
+            QMutex mutex;
+            // Keyed by the input string and the conversion flags, least recently used entries are dropped first
+            QCache<QPair<QString, int>, QRegularExpression> cache{RegexCacheSize};
+        };
+
+        Q_GLOBAL_STATIC(RegexCache, s_regexCache)
+    } // namespace
+
+    /**
+     * Convert a search string into a regular expression.
+     *
+     * Compiled expressions are cached, matching loops can call this for every
+     * item without compiling the same pattern again. The returned copy shares
+     * the compiled (and JIT compiled, where PCRE2 supports it) pattern of the
+     * cached expression. Safe to call from any thread.
+     */
     QRegularExpression convertToRegex(const QString& string, bool useWildcards, bool exactMatch, bool caseSensitive)
     {
+        const auto key = qMakePair(string, (useWildcards ? 1 : 0) | (exactMatch ? 2 : 0) | (caseSensitive ? 4 : 0));
+
+        QMutexLocker locker(&s_regexCache->mutex);
+        if (const auto* cached = s_regexCache->cache.object(key)) {
+            return *cached;
+        }
+        locker.unlock();
+
         QString pattern = string;
 
         // Wildcard support (*, ?, |)
@@ -312,7 +345,11 @@ namespace Tools
         if (!caseSensitive) {
             regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
         }
+        // Compile now instead of on first use so every copy shares the compiled pattern
+        regex.optimize();
 
+        locker.relock();
+        s_regexCache->cache.insert(key, new QRegularExpression(regex));
         return regex;
     }
 
@@ -0,0 +1,214 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Tracing.h"
+
+#include "core/Global.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+namespace
+{
+    // Stop recording after this many spans to bound the memory use of long sessions
+    constexpr int MaxEvents = 1 << 20;
+
+    struct Event
+    {
+        const char* name;
+        const char* category;
+        qint64 start;
+        qint64 duration;
+        int thread;
+        QVariantMap args;
+    };
+
+    struct TraceState
+    {
+        QMutex mutex;
+        QString fileName;
+        QElapsedTimer clock;
+        QVector<Event> events;
+        QMap<int, QString> threadNames;
+        bool cleanupRegistered = false;
+    };
+
+    std::atomic<bool> g_enabled{false};
+    Q_GLOBAL_STATIC(TraceState, s_state)
+
+    std::atomic<int> g_threadCounter{0};
+
+    // Small sequential ids are easier to read in trace viewers than native thread handles
+    int currentThreadIndex()
+    {
+        thread_local int index = 0;
+        if (index == 0) {
+            index = ++g_threadCounter;
+            auto* thread = QThread::currentThread();
+            QString name = thread ? thread->objectName() : QString();
+            if (name.isEmpty()) {
+                name = (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+                           ? QStringLiteral("main")
+                           : QStringLiteral("thread %1").arg(index);
+            }
+            QMutexLocker locker(&s_state->mutex);
+            s_state->threadNames.insert(index, name);
+        }
+        return index;
+    }
+
+    void stopAtExit()
+    {
+        Tracing::stop();
+    }
+} // namespace
+
+namespace Tracing
+{
+    bool isEnabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Start collecting spans, replacing any previous recording.
+     * The trace is written to the given file by stop() or on application exit.
+     */
+    bool start(const QString& fileName)
+    {
+        if (fileName.isEmpty()) {
+            return false;
+        }
+
+        QMutexLocker locker(&s_state->mutex);
+        s_state->fileName = fileName;
+        s_state->events.clear();
+        s_state->clock.start();
+        if (!s_state->cleanupRegistered) {
+            qAddPostRoutine(stopAtExit);
+            s_state->cleanupRegistered = true;
+        }
+        g_enabled = true;
+        return true;
+    }
+
+    /**
+     * Stop collecting spans and write the trace file.
+     *
+     * @return false if tracing was not enabled or the file could not be written
+     */
+    bool stop()
+    {
+        if (!g_enabled.exchange(false)) {
+            return false;
+        }
+
+        QMutexLocker locker(&s_state->mutex);
+        const auto pid = QCoreApplication::applicationPid();
+
+        QJsonArray traceEvents;
+        for (auto it = s_state->threadNames.constBegin(); it != s_state->threadNames.constEnd(); ++it) {
+            traceEvents.append(QJsonObject{{"name", "thread_name"},
+                                           {"ph", "M"},
+                                           {"pid", pid},
+                                           {"tid", it.key()},
+                                           {"args", QJsonObject{{"name", it.value()}}}});
+        }
+        for (const auto& event : asConst(s_state->events)) {
+            QJsonObject object{{"name", QString::fromLatin1(event.name)},
+                               {"cat", QString::fromLatin1(event.category)},
+                               {"ph", "X"},
+                               {"ts", event.start / 1000.0},
+                               {"dur", event.duration / 1000.0},
+                               {"pid", pid},
+                               {"tid", event.thread}};
+            if (!event.args.isEmpty()) {
+                object.insert("args", QJsonObject::fromVariantMap(event.args));
+            }
+            traceEvents.append(object);
+        }
+        s_state->events.clear();
+
+        QJsonObject trace{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+        QFile file(s_state->fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning("Unable to write trace file %s: %s",
+                     qPrintable(s_state->fileName),
+                     qPrintable(file.errorString()));
+            return false;
+        }
+        file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+        return true;
+    }
+
+    /**
+     * Start tracing if KEEPASSXC_TRACE names an output file.
+     */
+    void startFromEnvironment()
+    {
+        const auto fileName = QString::fromLocal8Bit(qgetenv("KEEPASSXC_TRACE"));
+        if (!fileName.isEmpty()) {
+            start(fileName);
+        }
+    }
+
+    Span::Span(const char* name, const char* category)
+        : m_name(name)
+        , m_category(category)
+        , m_start(-1)
+    {
+        if (isEnabled()) {
+            m_start = s_state->clock.nsecsElapsed();
+        }
+    }
+
+    Span::~Span()
+    {
+        if (m_start < 0 || !isEnabled()) {
+            return;
+        }
+
+        const qint64 end = s_state->clock.nsecsElapsed();
+        const int thread = currentThreadIndex();
+        QMutexLocker locker(&s_state->mutex);
+        if (s_state->events.size() < MaxEvents) {
+            s_state->events.append({m_name, m_category, m_start, end - m_start, thread, m_args});
+        }
+    }
+
+    bool Span::isActive() const
+    {
+        return m_start >= 0;
+    }
+
+    void Span::setArg(const QString& key, const QVariant& value)
+    {
+        if (isActive()) {
+            m_args.insert(key, value);
+        }
+    }
+} // namespace Tracing
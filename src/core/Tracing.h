@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_TRACING_H
+#define KEEPASSXC_TRACING_H
+
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * Lightweight timing instrumentation. Spans are collected in memory while
+ * tracing is enabled and written as Chrome trace event JSON when tracing
+ * stops, so they can be loaded in chrome://tracing or ui.perfetto.dev.
+ *
+ * Tracing is enabled by setting KEEPASSXC_TRACE to an output file name or
+ * by passing --trace to the application. Spans are cheap no-ops otherwise.
+ * Never record secrets (passwords, search terms, attribute values) as
+ * span arguments.
+ */
+namespace Tracing
+{
+    bool isEnabled();
+    bool start(const QString& fileName);
+    bool stop();
+    void startFromEnvironment();
+
+    /**
+     * Times the enclosing scope. The name and category must be string
+     * literals, they are only copied when the span is recorded.
+     */
+    class Span
+    {
+    public:
+        explicit Span(const char* name, const char* category = "core");
+        ~Span();
+
+        bool isActive() const;
+        void setArg(const QString& key, const QVariant& value);
+
+    private:
+        Q_DISABLE_COPY(Span)
+
+        const char* m_name;
+        const char* m_category;
+        qint64 m_start;
+        QVariantMap m_args;
+    };
+} // namespace Tracing
+
+#endif // KEEPASSXC_TRACING_H
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UsernameStatistics.h"
+
+#include "core/Entry.h"
+
+#include <algorithm>
+#include <vector>
+
+void UsernameStatistics::addEntry(const Entry* entry)
+{
+    if (m_entryUsernames.contains(entry)) {
+        updateEntry(entry);
+        return;
+    }
+    const QString username = countedUsername(entry);
+    m_entryUsernames.insert(entry, username);
+    increment(username);
+}
+
+void UsernameStatistics::removeEntry(const Entry* entry)
+{
+    auto it = m_entryUsernames.find(entry);
+    if (it == m_entryUsernames.end()) {
+        return;
+    }
+    decrement(it.value());
+    m_entryUsernames.erase(it);
+}
+
+/**
+ * Recount the username of an entry that is already known
+ */
+void UsernameStatistics::updateEntry(const Entry* entry)
+{
+    auto it = m_entryUsernames.find(entry);
+    if (it == m_entryUsernames.end()) {
+        return;
+    }
+    const QString username = countedUsername(entry);
+    if (username != it.value()) {
+        decrement(it.value());
+        increment(username);
+        it.value() = username;
+    }
+}
+
+void UsernameStatistics::clear()
+{
+    m_entryUsernames.clear();
+    m_counts.clear();
+}
+
+int UsernameStatistics::count(const QString& username) const
+{
+    return m_counts.value(username);
+}
+
+/**
+ * Most frequent usernames, ties are ordered by name
+ *
+ * @param topN maximum number of usernames, all usernames if negative
+ */
+QList<QString> UsernameStatistics::topUsernames(int topN) const
+{
+    using Frequency = QPair<QString, int>;
+    // Orders more frequent usernames first
+    auto isBetter = [](const Frequency& lhs, const Frequency& rhs) {
+        if (lhs.second == rhs.second) {
+            return lhs.first < rhs.first;
+        }
+        return lhs.second > rhs.second;
+    };
+
+    const int limit = topN < 0 ? m_counts.size() : qMin(topN, m_counts.size());
+    if (limit <= 0) {
+        return {};
+    }
+
+    // Keep the best candidates in a heap with the worst of them on top
+    std::vector<Frequency> heap;
+    heap.reserve(limit + 1);
+    for (auto it = m_counts.constBegin(); it != m_counts.constEnd(); ++it) {
+        Frequency candidate{it.key(), it.value()};
+        if (static_cast<int>(heap.size()) < limit) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        } else if (isBetter(candidate, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), isBetter);
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), isBetter);
+
+    QList<QString> usernames;
+    usernames.reserve(limit);
+    for (const auto& frequency : heap) {
+        usernames.append(frequency.first);
+    }
+    return usernames;
+}
+
+QString UsernameStatistics::countedUsername(const Entry* entry)
+{
+    // References to other entries do not count as usernames
+    if (entry->isAttributeReference(EntryAttributes::UserNameKey)) {
+        return {};
+    }
+    return entry->username();
+}
+
+void UsernameStatistics::increment(const QString& username)
+{
+    if (!username.isEmpty()) {
+        ++m_counts[username];
+    }
+}
+
+void UsernameStatistics::decrement(const QString& username)
+{
+    if (username.isEmpty()) {
+        return;
+    }
+    auto it = m_counts.find(username);
+    if (it != m_counts.end() && --it.value() <= 0) {
+        m_counts.erase(it);
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_USERNAMESTATISTICS_H
+#define KEEPASSXC_USERNAMESTATISTICS_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class Entry;
+
+/**
+ * Username frequencies of the entries of a database, kept up to date
+ * as entries are added, removed or changed.
+ */
+class UsernameStatistics
+{
+public:
+    void addEntry(const Entry* entry);
+    void removeEntry(const Entry* entry);
+    void updateEntry(const Entry* entry);
+    void clear();
+
+    int count(const QString& username) const;
+    QList<QString> topUsernames(int topN) const;
+
+private:
+    static QString countedUsername(const Entry* entry);
+    void increment(const QString& username);
+    void decrement(const QString& username);
+
+    QHash<const Entry*, QString> m_entryUsernames;
+    QHash<QString, int> m_counts;
+};
+
+#endif // KEEPASSXC_USERNAMESTATISTICS_H
@@ -20,6 +20,7 @@
 
 #include "crypto/CryptoHash.h"
 #include "crypto/SymmetricCipher.h"
+#include "crypto/kdf/KdfScheduler.h"
 
 #include <botan/version.h>
 
@@ -261,6 +262,14 @@ namespace Crypto
                              .arg(Botan::version_major())
                              .arg(Botan::version_minor())
                              .arg(Botan::version_patch()));
+
+        auto scheduler = KdfScheduler::instance();
+        debugInfo.append(QObject::tr("Key derivation: %1 running, %2 queued, %3 of %4 MiB reserved")
+                             .arg(scheduler->activeDerivations())
+                             .arg(scheduler->queueDepth())
+                             .arg(scheduler->memoryInUse() / (1024 * 1024))
+                             .arg(scheduler->memoryBudget() / (1024 * 1024))
+                             .append("\n"));
         return debugInfo;
     }
 } // namespace Crypto
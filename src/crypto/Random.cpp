@@ -24,8 +24,32 @@
 #include <QSharedPointer>
 
 #include <botan/auto_rng.h>
+#include <botan/mem_ops.h>
 #include <botan/system_rng.h>
 
+#include <array>
+#include <cstring>
+
+namespace
+{
+    // Requests up to this many bytes are served from a per-thread buffer
+    // that is refilled from the shared RNG in one large chunk. This avoids
+    // a system call (and lock contention) for every small request.
+    constexpr size_t MaxBufferedRequest = 64;
+    constexpr size_t BufferSize = 4096;
+
+    struct RandomBuffer
+    {
+        std::array<uint8_t, BufferSize> data;
+        size_t pos = BufferSize;
+
+        ~RandomBuffer()
+        {
+            Botan::secure_scrub_memory(data.data(), data.size());
+        }
+    };
+} // namespace
+
 QSharedPointer<Random> Random::m_instance;
 
 QSharedPointer<Random> Random::instance()
@@ -50,9 +74,29 @@ QSharedPointer<Botan::RandomNumberGenerator> Random::getRng()
     return m_rng;
 }
 
+void Random::fill(uint8_t* out, size_t len)
+{
+    if (len > MaxBufferedRequest) {
+        m_rng->randomize(out, len);
+        return;
+    }
+
+    thread_local RandomBuffer buffer;
+    if (buffer.pos + len > BufferSize) {
+        m_rng->randomize(buffer.data.data(), BufferSize);
+        buffer.pos = 0;
+    }
+
+    // Scrub the bytes we hand out so they can never be served twice
+    uint8_t* src = buffer.data.data() + buffer.pos;
+    std::memcpy(out, src, len);
+    Botan::secure_scrub_memory(src, len);
+    buffer.pos += len;
+}
+
 void Random::randomize(QByteArray& ba)
 {
-    m_rng->randomize(reinterpret_cast<uint8_t*>(ba.data()), ba.size());
+    fill(reinterpret_cast<uint8_t*>(ba.data()), static_cast<size_t>(ba.size()));
 }
 
 QByteArray Random::randomArray(int len)
@@ -74,7 +118,7 @@ quint32 Random::randomUInt(quint32 limit)
 
     // To avoid modulo bias make sure rand is below the largest number where rand%limit==0
     do {
-        m_rng->randomize(reinterpret_cast<uint8_t*>(&rand), 4);
+        fill(reinterpret_cast<uint8_t*>(&rand), sizeof(rand));
     } while (rand > ceil);
 
     return (rand % limit);
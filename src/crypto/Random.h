@@ -48,6 +48,8 @@ private:
     explicit Random();
     Q_DISABLE_COPY(Random);
 
+    void fill(uint8_t* out, size_t len);
+
     static QSharedPointer<Random> m_instance;
     QSharedPointer<Botan::RandomNumberGenerator> m_rng;
 };
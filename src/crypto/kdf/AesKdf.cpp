@@ -95,22 +95,17 @@ QSharedPointer<Kdf> AesKdf::clone() const
 
 int AesKdf::benchmark(int msec) const
 {
-    QByteArray key(16, '\x7E');
-    QByteArray seed(32, '\x4B');
-
-    int trials = 3;
-    int rounds = 1000000;
-
-    QElapsedTimer timer;
-    timer.start();
-    for (int i = 0; i < trials; ++i) {
-        QByteArray result;
-        if (!transformKeyRaw(key, seed, rounds, &result)) {
-            return rounds;
-        }
-    }
-
-    return static_cast<int>(rounds * trials * static_cast<float>(msec) / timer.elapsed());
+    const QByteArray key(16, '\x7E');
+    const QByteArray seed(32, '\x4B');
+
+    // Both key halves are transformed concurrently, exactly as in transform()
+    return calibrateRounds(msec, 1000, [&key, &seed](int rounds) {
+        QByteArray resultLeft;
+        QByteArray resultRight;
+        QFuture<bool> future = QtConcurrent::run(transformKeyRaw, key, seed, rounds, &resultLeft);
+        bool rightResult = transformKeyRaw(key, seed, rounds, &resultRight);
+        return future.result() && rightResult;
+    });
 }
 
 QString AesKdf::toString() const
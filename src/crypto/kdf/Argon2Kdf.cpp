@@ -20,6 +20,7 @@
 #include <QtConcurrent>
 #include <botan/pwdhash.h>
 
+#include "crypto/kdf/KdfScheduler.h"
 #include "format/KeePass2.h"
 
 /**
@@ -163,6 +164,13 @@ bool Argon2Kdf::transform(const QByteArray& raw, QByteArray& result) const
 {
     result.clear();
     result.resize(32);
+
+    KdfScheduler::Reservation reservation(memory() * 1024);
+    if (!reservation.isValid()) {
+        qWarning("Argon2 error: key derivation was cancelled");
+        return false;
+    }
+
     try {
         auto algo = type() == Type::Argon2d ? "Argon2d" : "Argon2id";
         auto pwhash = Botan::PasswordHashFamily::create_or_throw(algo)->from_params(memory(), rounds(), parallelism());
@@ -186,11 +194,29 @@ QSharedPointer<Kdf> Argon2Kdf::clone() const
 
 int Argon2Kdf::benchmark(int msec) const
 {
+    KdfScheduler::Reservation reservation(memory() * 1024);
+    if (!reservation.isValid()) {
+        return 1;
+    }
+
     try {
         auto algo = type() == Type::Argon2d ? "Argon2d" : "Argon2id";
-        auto pwhash = Botan::PasswordHashFamily::create_or_throw(algo)->tune(
-            32, std::chrono::milliseconds(msec), memory() / 1024);
-        return qMax(static_cast<size_t>(1), pwhash->iterations());
+        auto family = Botan::PasswordHashFamily::create_or_throw(algo);
+        const QByteArray password(32, '\x7E');
+        const QByteArray salt(32, '\x4B');
+
+        // Calibrate iterations at the configured memory and parallelism
+        return calibrateRounds(msec, 1, [&](int rounds) {
+            uint8_t result[32];
+            auto pwhash = family->from_params(memory(), static_cast<size_t>(rounds), parallelism());
+            pwhash->derive_key(result,
+                               sizeof(result),
+                               password.constData(),
+                               password.size(),
+                               reinterpret_cast<const uint8_t*>(salt.constData()),
+                               salt.size());
+            return true;
+        });
     } catch (std::exception& e) {
         return 1;
     }
@@ -17,6 +17,8 @@
 
 #include "Kdf.h"
 
+#include <QElapsedTimer>
+#include <QVector>
 #include <QtConcurrent>
 
 #include "crypto/Random.h"
@@ -67,3 +69,75 @@ void Kdf::randomizeSeed()
 {
     setSeed(randomGen()->randomArray(m_seed.size()));
 }
+
+/**
+ * Determine the number of rounds for which a derivation takes @p msec on this machine.
+ *
+ * After an untimed warmup run, the derivation is timed at exponentially growing
+ * round counts until a sample takes at least a quarter of the target time.
+ * A least-squares fit of time = overhead + rounds * cost over these samples
+ * separates fixed setup costs (memory allocation, thread start-up) from the
+ * per-round cost, which a single extrapolated sample cannot do.
+ *
+ * @param msec target derivation time in milliseconds
+ * @param minRounds smallest sensible round count, also used for the warmup
+ * @param derive runs a full derivation with the given number of rounds
+ * @return calibrated number of rounds
+ */
+int Kdf::calibrateRounds(int msec, int minRounds, const std::function<bool(int)>& derive)
+{
+    if (!derive(minRounds)) {
+        return minRounds;
+    }
+
+    const double targetNs = msec * 1e6;
+    const double probeNs = qMax(targetNs / 4, 20e6);
+    // Samples shorter than this are dominated by timer and scheduling noise
+    const double noiseNs = 1e6;
+
+    QVector<QPair<double, double>> samples;
+    QElapsedTimer timer;
+    int rounds = minRounds;
+    while (true) {
+        timer.start();
+        if (!derive(rounds)) {
+            return minRounds;
+        }
+        const double elapsed = static_cast<double>(timer.nsecsElapsed());
+        if (elapsed >= noiseNs) {
+            samples.append({static_cast<double>(rounds), elapsed});
+        }
+        if (elapsed >= probeNs || rounds > INT_MAX / 2) {
+            if (samples.isEmpty()) {
+                samples.append({static_cast<double>(rounds), qMax(elapsed, 1.0)});
+            }
+            break;
+        }
+        rounds *= 2;
+    }
+
+    double overhead = 0;
+    double cost = samples.last().second / samples.last().first;
+    if (samples.size() >= 2) {
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (const auto& sample : samples) {
+            sx += sample.first;
+            sy += sample.second;
+            sxx += sample.first * sample.first;
+            sxy += sample.first * sample.second;
+        }
+        const double n = samples.size();
+        const double denominator = n * sxx - sx * sx;
+        const double slope = denominator > 0 ? (n * sxy - sx * sy) / denominator : 0;
+        if (slope > 0) {
+            cost = slope;
+            overhead = qMax(0.0, (sy - slope * sx) / n);
+        }
+    }
+
+    const double result = (targetNs - overhead) / cost;
+    if (result >= INT_MAX - 1) {
+        return INT_MAX - 1;
+    }
+    return qMax(minRounds, static_cast<int>(result));
+}
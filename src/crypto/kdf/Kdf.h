@@ -21,6 +21,8 @@
 #include <QUuid>
 #include <QVariant>
 
+#include <functional>
+
 #define KDF_MIN_SEED_SIZE 8
 #define KDF_MAX_SEED_SIZE 32
 #define KDF_DEFAULT_ROUNDS 1000000ull
@@ -61,6 +63,8 @@ public:
      */
     static const int MAX_ENCRYPTION_TIME = 5000;
 
+    static int calibrateRounds(int msec, int minRounds, const std::function<bool(int)>& derive);
+
 protected:
     int m_rounds;
     QByteArray m_seed;
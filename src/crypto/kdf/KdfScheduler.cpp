@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KdfScheduler.h"
+
+#include "core/AsyncTask.h"
+#include "core/Global.h"
+
+#include <QGuiApplication>
+#include <QThread>
+
+namespace
+{
+    thread_local KdfScheduler::Priority t_priority = KdfScheduler::Priority::Interactive;
+    thread_local const void* t_owner = nullptr;
+
+    int index(KdfScheduler::Priority priority)
+    {
+        return priority == KdfScheduler::Priority::Interactive ? 0 : 1;
+    }
+} // namespace
+
+KdfScheduler::Reservation::Reservation(quint64 bytes)
+    : m_bytes(bytes)
+    , m_valid(false)
+{
+    auto scheduler = KdfScheduler::instance();
+    const auto priority = KdfScheduler::currentPriority();
+    const auto owner = KdfScheduler::currentOwner();
+    if (scheduler->tryAcquire(bytes, priority)) {
+        m_valid = true;
+        return;
+    }
+
+    auto* app = QCoreApplication::instance();
+    if (!app || QThread::currentThread() != app->thread()) {
+        m_valid = scheduler->acquire(bytes, priority, owner);
+        return;
+    }
+
+    // Wait on a worker thread, so the GUI keeps responding while other derivations finish
+    auto* guiApp = qobject_cast<QGuiApplication*>(app);
+    if (guiApp) {
+        guiApp->setOverrideCursor(Qt::BusyCursor);
+    }
+    m_valid = AsyncTask::runAndWaitForFuture(
+        [scheduler, bytes, priority, owner] { return scheduler->acquire(bytes, priority, owner); });
+    if (guiApp) {
+        guiApp->restoreOverrideCursor();
+    }
+}
+
+KdfScheduler::Reservation::~Reservation()
+{
+    if (m_valid) {
+        KdfScheduler::instance()->release(m_bytes);
+    }
+}
+
+bool KdfScheduler::Reservation::isValid() const
+{
+    return m_valid;
+}
+
+KdfScheduler::PriorityScope::PriorityScope(Priority priority, const void* owner)
+    : m_previous(t_priority)
+    , m_previousOwner(t_owner)
+{
+    t_priority = priority;
+    t_owner = owner;
+}
+
+KdfScheduler::PriorityScope::~PriorityScope()
+{
+    t_priority = m_previous;
+    t_owner = m_previousOwner;
+}
+
+KdfScheduler* KdfScheduler::instance()
+{
+    static KdfScheduler scheduler;
+    return &scheduler;
+}
+
+KdfScheduler::Priority KdfScheduler::currentPriority()
+{
+    return t_priority;
+}
+
+const void* KdfScheduler::currentOwner()
+{
+    return t_owner;
+}
+
+bool KdfScheduler::canRun(quint64 bytes, Priority priority) const
+{
+    if (priority == Priority::Background && m_waiting[index(Priority::Interactive)] > 0) {
+        return false;
+    }
+    return m_active == 0 || m_inUse + bytes <= m_budget;
+}
+
+/**
+ * Reserve memory for a derivation, blocking until it fits into the budget.
+ *
+ * @param bytes working memory of the derivation
+ * @param priority scheduling priority
+ * @param owner object the derivation is made for, nullptr if it cannot be cancelled
+ * @return false if the request was cancelled while waiting
+ */
+bool KdfScheduler::acquire(quint64 bytes, Priority priority, const void* owner)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const int i = index(priority);
+    Waiter waiter{owner, false};
+    ++m_waiting[i];
+    m_waiters.append(&waiter);
+    while (!canRun(bytes, priority) && !waiter.cancelled) {
+        m_condition.wait(&m_mutex);
+    }
+    m_waiters.removeOne(&waiter);
+    --m_waiting[i];
+
+    if (waiter.cancelled) {
+        // Waiters held back by this one may be able to run now
+        m_condition.wakeAll();
+        return false;
+    }
+
+    m_inUse += bytes;
+    ++m_active;
+    return true;
+}
+
+/**
+ * Reserve memory for a derivation if it fits into the budget right away.
+ *
+ * @return false if the derivation would have to wait
+ */
+bool KdfScheduler::tryAcquire(quint64 bytes, Priority priority)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_waiting[index(priority)] > 0 || !canRun(bytes, priority)) {
+        return false;
+    }
+
+    m_inUse += bytes;
+    ++m_active;
+    return true;
+}
+
+void KdfScheduler::release(quint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    Q_ASSERT(m_active > 0 && m_inUse >= bytes);
+    m_inUse -= bytes;
+    --m_active;
+    m_condition.wakeAll();
+}
+
+/**
+ * Abort the derivations made for the given owner that are still waiting
+ * for memory. Running derivations and those of other owners are not affected.
+ */
+void KdfScheduler::cancelPending(const void* owner)
+{
+    if (!owner) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    for (Waiter* waiter : asConst(m_waiters)) {
+        if (waiter->owner == owner) {
+            waiter->cancelled = true;
+        }
+    }
+    m_condition.wakeAll();
+}
+
+quint64 KdfScheduler::memoryBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+void KdfScheduler::setMemoryBudget(quint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = bytes;
+    m_condition.wakeAll();
+}
+
+quint64 KdfScheduler::memoryInUse() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inUse;
+}
+
+int KdfScheduler::activeDerivations() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_active;
+}
+
+int KdfScheduler::queueDepth() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_waiting[0] + m_waiting[1];
+}
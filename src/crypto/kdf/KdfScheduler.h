@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_KDFSCHEDULER_H
+#define KEEPASSXC_KDFSCHEDULER_H
+
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+
+/**
+ * Process-wide gate for memory-hard key derivations.
+ *
+ * Every derivation reserves its working memory before it starts. Reservations
+ * that would exceed the memory budget wait until enough memory is released;
+ * interactive derivations (unlocking, saving) are admitted before background
+ * ones (KeeShare exports). A single derivation larger than the budget is
+ * still admitted once nothing else is running.
+ *
+ * A reservation made on the GUI thread waits without blocking the event
+ * loop and shows a busy cursor while it waits.
+ */
+class KdfScheduler
+{
+public:
+    enum class Priority
+    {
+        Interactive,
+        Background
+    };
+
+    /**
+     * RAII memory reservation, check isValid() before deriving.
+     */
+    class Reservation
+    {
+    public:
+        explicit Reservation(quint64 bytes);
+        ~Reservation();
+        bool isValid() const;
+
+    private:
+        Q_DISABLE_COPY(Reservation)
+        quint64 m_bytes;
+        bool m_valid;
+    };
+
+    /**
+     * Run all derivations started by the current thread within the
+     * lifetime of this object at the given priority. Derivations made
+     * on behalf of an owner, e.g. the database they export, can be
+     * cancelled with cancelPending() while they wait for memory.
+     */
+    class PriorityScope
+    {
+    public:
+        explicit PriorityScope(Priority priority, const void* owner = nullptr);
+        ~PriorityScope();
+
+    private:
+        Q_DISABLE_COPY(PriorityScope)
+        Priority m_previous;
+        const void* m_previousOwner;
+    };
+
+    static KdfScheduler* instance();
+
+    bool acquire(quint64 bytes, Priority priority, const void* owner = nullptr);
+    bool tryAcquire(quint64 bytes, Priority priority);
+    void release(quint64 bytes);
+    void cancelPending(const void* owner);
+
+    quint64 memoryBudget() const;
+    void setMemoryBudget(quint64 bytes);
+    quint64 memoryInUse() const;
+    int activeDerivations() const;
+    int queueDepth() const;
+
+    static Priority currentPriority();
+    static const void* currentOwner();
+
+    static const quint64 DEFAULT_MEMORY_BUDGET = 1ULL << 30;
+
+private:
+    KdfScheduler() = default;
+    Q_DISABLE_COPY(KdfScheduler)
+
+    struct Waiter
+    {
+        const void* owner;
+        bool cancelled;
+    };
+
+    bool canRun(quint64 bytes, Priority priority) const;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+    quint64 m_budget = DEFAULT_MEMORY_BUDGET;
+    quint64 m_inUse = 0;
+    int m_active = 0;
+    int m_waiting[2] = {0, 0};
+    QList<Waiter*> m_waiters;
+};
+
+#endif // KEEPASSXC_KDFSCHEDULER_H
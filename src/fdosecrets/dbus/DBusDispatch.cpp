@@ -23,6 +23,7 @@
 #include "fdosecrets/objects/Service.h"
 
 #include "core/Global.h"
+#include "core/Tracing.h"
 
 #include <QDBusMetaType>
 #include <QThread>
@@ -170,6 +171,12 @@ namespace FdoSecrets
 
     bool DBusMgr::handleMessage(const QDBusMessage& message, const QDBusConnection&)
     {
+        Tracing::Span span("DBusMgr::handleMessage", "fdosecrets");
+        if (span.isActive()) {
+            span.setArg("interface", message.interface());
+            span.setArg("member", message.member());
+        }
+
         // save a mutable copy of the message, as we may modify it to unify property access
         // and method call
         RequestedMethod req{
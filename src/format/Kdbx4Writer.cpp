@@ -215,23 +215,43 @@ bool Kdbx4Writer::writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeader
     return true;
 }
 
+/**
+ * Write an inner header field whose data is preceded by a flag byte,
+ * without copying the data into a new buffer.
+ */
+bool Kdbx4Writer::writeInnerHeaderField(QIODevice* device,
+                                        KeePass2::InnerHeaderFieldID fieldId,
+                                        char flags,
+                                        const QByteArray& data)
+{
+    QByteArray header;
+    header.append(static_cast<char>(fieldId));
+    header.append(Endian::sizedIntToBytes(static_cast<quint32>(data.size() + 1), KeePass2::BYTEORDER));
+    header.append(flags);
+    CHECK_RETURN_FALSE(writeData(device, header));
+    CHECK_RETURN_FALSE(writeData(device, data));
+
+    return true;
+}
+
 void Kdbx4Writer::writeAttachments(QIODevice* device, Database* db)
 {
     const QList<Entry*> allEntries = db->rootGroup()->entriesRecursive(true);
     QSet<QByteArray> writtenAttachments;
 
+    // Same order as the binary pool IDs in KdbxXmlWriter, deduplicated by digest
     for (Entry* entry : allEntries) {
         const QList<QString> attachmentKeys = entry->attachments()->keys();
         for (const QString& key : attachmentKeys) {
-            QByteArray data("\x01");
-            data.append(entry->attachments()->value(key));
-
-            if (writtenAttachments.contains(data)) {
+            const QByteArray digest = entry->attachments()->digest(key);
+            if (writtenAttachments.contains(digest)) {
                 continue;
             }
 
-            writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data);
-            writtenAttachments.insert(data);
+            // Binaries start with a flag byte, 0x01 marks them as protected
+            writeInnerHeaderField(
+                device, KeePass2::InnerHeaderFieldID::Binary, '\x01', entry->attachments()->value(key));
+            writtenAttachments.insert(digest);
         }
     }
 }
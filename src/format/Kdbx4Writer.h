@@ -33,6 +33,10 @@ public:
 
 private:
     bool writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeaderFieldID fieldId, const QByteArray& data);
+    bool writeInnerHeaderField(QIODevice* device,
+                               KeePass2::InnerHeaderFieldID fieldId,
+                               char flags,
+                               const QByteArray& data);
     void writeAttachments(QIODevice* device, Database* db);
     static bool serializeVariantMap(const QVariantMap& map, QByteArray& outputBytes);
 };
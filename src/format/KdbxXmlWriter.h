@@ -51,7 +51,7 @@ private:
     void writeMetadata();
     void writeMemoryProtection();
     void writeCustomIcons();
-    void writeIcon(const QUuid& uuid, const QImage& icon);
+    void writeIcon(const QUuid& uuid, const QByteArray& iconData);
     void writeBinaries();
     void writeCustomData(const CustomData* customData);
     void writeCustomDataItem(const QString& key, const QString& value);
@@ -87,7 +87,9 @@ private:
     QPointer<const Database> m_db;
     QPointer<const Metadata> m_meta;
     KeePass2RandomStream* m_randomStream = nullptr;
+    // Binary pool IDs by attachment digest and the binaries in ID order
     QHash<QByteArray, int> m_idMap;
+    QList<QByteArray> m_binaries;
     QByteArray m_headerHash;
 
     bool m_error = false;
@@ -33,6 +33,10 @@
 #include "MessageBox.h"
 #include "touchid/TouchID.h"
 
+#ifdef WITH_XC_NETWORKING
+#include "gui/IconDownloadScheduler.h"
+#endif
+
 class ApplicationSettingsWidget::ExtraPage
 {
 public:
@@ -136,7 +140,12 @@ ApplicationSettingsWidget::ApplicationSettingsWidget(QWidget* parent)
     m_generalUi->checkUpdatesSpacer->changeSize(0, 0, QSizePolicy::Fixed, QSizePolicy::Fixed);
 #endif
 
-#ifndef WITH_XC_NETWORKING
+#ifdef WITH_XC_NETWORKING
+    connect(m_secUi->clearIconCacheButton, &QPushButton::clicked, this, [this] {
+        IconDownloadScheduler::clearCache(IconDownloadScheduler::defaultCacheDirectory());
+        m_secUi->clearIconCacheButton->setEnabled(false);
+    });
+#else
     m_secUi->privacy->setVisible(false);
     m_generalUi->faviconTimeoutLabel->setVisible(false);
     m_generalUi->faviconTimeoutSpinBox->setVisible(false);
@@ -183,6 +192,7 @@ void ApplicationSettingsWidget::loadSettings()
     m_generalUi->openPreviousDatabasesOnStartupCheckBox->setChecked(
         config()->get(Config::OpenPreviousDatabasesOnStartup).toBool());
     m_generalUi->autoSaveAfterEveryChangeCheckBox->setChecked(config()->get(Config::AutoSaveAfterEveryChange).toBool());
+    m_generalUi->autoSaveUseJournalCheckBox->setChecked(config()->get(Config::AutoSaveUseJournal).toBool());
     m_generalUi->autoSaveOnExitCheckBox->setChecked(config()->get(Config::AutoSaveOnExit).toBool());
     m_generalUi->autoSaveNonDataChangesCheckBox->setChecked(config()->get(Config::AutoSaveNonDataChanges).toBool());
     m_generalUi->backupBeforeSaveCheckBox->setChecked(config()->get(Config::BackupBeforeSave).toBool());
@@ -276,6 +286,8 @@ void ApplicationSettingsWidget::loadSettings()
         config()->get(Config::Security_LockDatabaseScreenLock).toBool());
     m_secUi->relockDatabaseAutoTypeCheckBox->setChecked(config()->get(Config::Security_RelockAutoType).toBool());
     m_secUi->fallbackToSearch->setChecked(config()->get(Config::Security_IconDownloadFallback).toBool());
+    m_secUi->iconCacheCheckBox->setChecked(config()->get(Config::Security_IconDownloadCache).toBool());
+    m_secUi->clearIconCacheButton->setEnabled(true);
 
     m_secUi->passwordsHiddenCheckBox->setChecked(config()->get(Config::Security_PasswordsHidden).toBool());
     m_secUi->passwordShowDotsCheckBox->setChecked(config()->get(Config::Security_PasswordEmptyPlaceholder).toBool());
@@ -320,6 +332,7 @@ void ApplicationSettingsWidget::saveSettings()
     config()->set(Config::OpenPreviousDatabasesOnStartup,
                   m_generalUi->openPreviousDatabasesOnStartupCheckBox->isChecked());
     config()->set(Config::AutoSaveAfterEveryChange, m_generalUi->autoSaveAfterEveryChangeCheckBox->isChecked());
+    config()->set(Config::AutoSaveUseJournal, m_generalUi->autoSaveUseJournalCheckBox->isChecked());
     config()->set(Config::AutoSaveOnExit, m_generalUi->autoSaveOnExitCheckBox->isChecked());
     config()->set(Config::AutoSaveNonDataChanges, m_generalUi->autoSaveNonDataChangesCheckBox->isChecked());
     config()->set(Config::BackupBeforeSave, m_generalUi->backupBeforeSaveCheckBox->isChecked());
@@ -380,6 +393,7 @@ void ApplicationSettingsWidget::saveSettings()
     config()->set(Config::Security_LockDatabaseScreenLock, m_secUi->lockDatabaseOnScreenLockCheckBox->isChecked());
     config()->set(Config::Security_RelockAutoType, m_secUi->relockDatabaseAutoTypeCheckBox->isChecked());
     config()->set(Config::Security_IconDownloadFallback, m_secUi->fallbackToSearch->isChecked());
+    config()->set(Config::Security_IconDownloadCache, m_secUi->iconCacheCheckBox->isChecked());
 
     config()->set(Config::Security_PasswordsHidden, m_secUi->passwordsHiddenCheckBox->isChecked());
     config()->set(Config::Security_PasswordEmptyPlaceholder, m_secUi->passwordShowDotsCheckBox->isChecked());
@@ -471,6 +485,7 @@ void ApplicationSettingsWidget::autoSaveToggled(bool checked)
     }
     m_generalUi->autoSaveOnExitCheckBox->setEnabled(!checked);
     m_generalUi->autoSaveNonDataChangesCheckBox->setEnabled(!checked);
+    m_generalUi->autoSaveUseJournalCheckBox->setEnabled(checked);
 }
 
 void ApplicationSettingsWidget::hideWindowOnCopyCheckBoxToggled(bool checked)
@@ -29,6 +29,7 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
+#include "crypto/kdf/KdfScheduler.h"
 #include "format/CsvExporter.h"
 #include "format/HtmlExporter.h"
 #include "gui/Clipboard.h"
@@ -342,6 +343,9 @@ bool DatabaseTabWidget::closeDatabaseTab(DatabaseWidget* dbWidget)
         return false;
     }
 
+    // Give up on KeeShare exports of this database that are still waiting for memory
+    KdfScheduler::instance()->cancelPending(dbWidget->database().data());
+
     removeTab(tabIndex);
     dbWidget->deleteLater();
     toggleTabbar();
@@ -79,6 +79,14 @@
 #include "sshagent/SSHAgent.h"
 #endif
 
+namespace
+{
+    // Journaled changes are written into the database file after this much inactivity
+    constexpr int JournalCompactionIdleTime = 5 * 60 * 1000;
+    // ... or as soon as the journal grows beyond this size
+    constexpr qint64 JournalCompactionSize = 4 * 1024 * 1024;
+} // namespace
+
 DatabaseWidget::DatabaseWidget(QSharedPointer<Database> db, QWidget* parent)
     : QStackedWidget(parent)
     , m_db(std::move(db))
@@ -213,6 +221,14 @@ DatabaseWidget::DatabaseWidget(QSharedPointer<Database> db, QWidget* parent)
 
     m_blockAutoSave = false;
 
+    m_journalCompactionTimer.setSingleShot(true);
+    m_journalCompactionTimer.setInterval(JournalCompactionIdleTime);
+    connect(&m_journalCompactionTimer, &QTimer::timeout, this, [this] {
+        if (!isLocked() && m_db->isModified()) {
+            save();
+        }
+    });
+
     m_searchLimitGroup = config()->get(Config::SearchLimitGroup).toBool();
 
 #ifdef WITH_XC_KEESHARE
@@ -1344,7 +1360,12 @@ void DatabaseWidget::onGroupChanged()
 void DatabaseWidget::onDatabaseModified()
 {
     if (!m_blockAutoSave && config()->get(Config::AutoSaveAfterEveryChange).toBool() && !m_db->isReadOnly()) {
-        save();
+        if (config()->get(Config::AutoSaveUseJournal).toBool() && m_db->appendToJournal()
+            && m_db->journalSize() < JournalCompactionSize) {
+            m_journalCompactionTimer.start();
+        } else {
+            save();
+        }
     } else {
         // Only block once, then reset
         m_blockAutoSave = false;
@@ -1509,6 +1530,9 @@ bool DatabaseWidget::lock()
                 }
             } else if (result == MessageBox::Cancel) {
                 return false;
+            } else {
+                // Don't replay the discarded changes on the next unlock
+                m_db->discardJournal();
             }
         }
     } else if (m_db->hasNonDataChanges() && config()->get(Config::AutoSaveNonDataChanges).toBool()) {
@@ -295,6 +295,9 @@ private:
 
     // Autoreload
     bool m_blockAutoSave;
+
+    // Folds the change journal into the database file once editing has settled
+    QTimer m_journalCompactionTimer;
 };
 
 #endif // KEEPASSX_DATABASEWIDGET_H
@@ -0,0 +1,290 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IconDownloadScheduler.h"
+
+#include "core/Clock.h"
+#include "core/Global.h"
+#include "crypto/Random.h"
+#include "gui/IconDownloader.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+namespace
+{
+    constexpr int DefaultMaxConcurrentDownloads = 8;
+    // Cached icons are downloaded again after this many days
+    constexpr int CacheMaxAgeDays = 30;
+    constexpr int CacheSaltSize = 32;
+    const QString CacheSaltFile = QStringLiteral("salt");
+} // namespace
+
+IconDownloadScheduler::IconDownloadScheduler(QObject* parent)
+    : QObject(parent)
+    , m_maxConcurrent(DefaultMaxConcurrentDownloads)
+    , m_pendingCount(0)
+    , m_schedulingRequested(false)
+{
+}
+
+IconDownloadScheduler::~IconDownloadScheduler()
+{
+    abort();
+}
+
+void IconDownloadScheduler::setMaxConcurrentDownloads(int count)
+{
+    m_maxConcurrent = qMax(1, count);
+    requestScheduling();
+}
+
+int IconDownloadScheduler::maxConcurrentDownloads() const
+{
+    return m_maxConcurrent;
+}
+
+/**
+ * Set the directory of the favicon cache. The cache is disabled by default
+ * and an empty path disables it again.
+ */
+void IconDownloadScheduler::setCacheDirectory(const QString& path)
+{
+    m_cacheDir = path;
+    m_cacheSalt.clear();
+}
+
+QString IconDownloadScheduler::cacheDirectory() const
+{
+    return m_cacheDir;
+}
+
+QString IconDownloadScheduler::defaultCacheDirectory()
+{
+    const auto cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheLocation.isEmpty()) {
+        return {};
+    }
+    return QDir(cacheLocation).filePath("favicons");
+}
+
+/**
+ * Remove a favicon cache directory with all icons in it.
+ *
+ * @return true if the directory no longer exists
+ */
+bool IconDownloadScheduler::clearCache(const QString& path)
+{
+    if (path.isEmpty()) {
+        return false;
+    }
+    return QDir(path).removeRecursively();
+}
+
+/**
+ * Queue the favicon download for an entry URL. Downloads start once control
+ * returns to the event loop.
+ */
+void IconDownloadScheduler::enqueue(const QString& url)
+{
+    ++m_pendingCount;
+
+    const auto domain = IconDownloader::registrableDomain(url);
+    if (domain.isEmpty()) {
+        m_invalidUrls.append(url);
+    } else {
+        auto it = m_urlsByDomain.find(domain);
+        if (it == m_urlsByDomain.end()) {
+            m_urlsByDomain.insert(domain, {url});
+            m_queue.enqueue(domain);
+        } else {
+            it->append(url);
+        }
+    }
+
+    requestScheduling();
+}
+
+/**
+ * @return number of queued URLs the finished() signal has not been emitted for yet
+ */
+int IconDownloadScheduler::pendingCount() const
+{
+    return m_pendingCount;
+}
+
+int IconDownloadScheduler::activeDownloads() const
+{
+    return m_activeDownloads.size();
+}
+
+void IconDownloadScheduler::abort()
+{
+    const auto downloaders = m_activeDownloads.keys();
+    m_activeDownloads.clear();
+    for (auto* downloader : downloaders) {
+        downloader->disconnect(this);
+        delete downloader;
+    }
+
+    m_queue.clear();
+    m_urlsByDomain.clear();
+    m_invalidUrls.clear();
+    m_pendingCount = 0;
+}
+
+void IconDownloadScheduler::requestScheduling()
+{
+    // Collapse many requests into one pass and avoid deep recursion when
+    // downloads finish synchronously
+    if (!m_schedulingRequested) {
+        m_schedulingRequested = true;
+        QMetaObject::invokeMethod(this, "scheduleDownloads", Qt::QueuedConnection);
+    }
+}
+
+void IconDownloadScheduler::scheduleDownloads()
+{
+    m_schedulingRequested = false;
+
+    const QStringList invalidUrls = m_invalidUrls;
+    m_invalidUrls.clear();
+    for (const auto& url : invalidUrls) {
+        --m_pendingCount;
+        emit finished(url, QImage());
+    }
+
+    while (m_activeDownloads.size() < m_maxConcurrent && !m_queue.isEmpty()) {
+        const auto domain = m_queue.dequeue();
+        if (!m_urlsByDomain.contains(domain)) {
+            continue;
+        }
+
+        const auto icon = cachedIcon(domain);
+        if (!icon.isNull()) {
+            finishDomain(domain, icon);
+            continue;
+        }
+
+        auto* downloader = new IconDownloader(this);
+        connect(downloader, &IconDownloader::finished, this, &IconDownloadScheduler::downloadFinished);
+        m_activeDownloads.insert(downloader, domain);
+        downloader->setUrl(m_urlsByDomain.value(domain).first());
+        downloader->download();
+    }
+}
+
+void IconDownloadScheduler::downloadFinished(const QString& url, const QImage& image)
+{
+    Q_UNUSED(url);
+
+    auto* downloader = qobject_cast<IconDownloader*>(sender());
+    if (!downloader || !m_activeDownloads.contains(downloader)) {
+        return;
+    }
+
+    const auto domain = m_activeDownloads.take(downloader);
+    downloader->deleteLater();
+
+    if (!image.isNull()) {
+        storeIcon(domain, image);
+    }
+    finishDomain(domain, image);
+    requestScheduling();
+}
+
+void IconDownloadScheduler::finishDomain(const QString& domain, const QImage& image)
+{
+    const auto urls = m_urlsByDomain.take(domain);
+    m_pendingCount -= urls.size();
+    for (const auto& url : urls) {
+        emit finished(url, image);
+    }
+}
+
+/**
+ * Random salt of the cache directory, created with the first stored icon.
+ * A cleared cache gets a new salt.
+ */
+QByteArray IconDownloadScheduler::cacheSalt(bool create) const
+{
+    if (!m_cacheSalt.isEmpty()) {
+        return m_cacheSalt;
+    }
+
+    QFile file(QDir(m_cacheDir).filePath(CacheSaltFile));
+    if (file.open(QIODevice::ReadOnly)) {
+        m_cacheSalt = file.read(CacheSaltSize);
+        if (m_cacheSalt.size() == CacheSaltSize) {
+            return m_cacheSalt;
+        }
+        m_cacheSalt.clear();
+        file.close();
+    }
+
+    if (create && file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        const auto salt = randomGen()->randomArray(CacheSaltSize);
+        if (file.write(salt) == salt.size()) {
+            m_cacheSalt = salt;
+        }
+    }
+    return m_cacheSalt;
+}
+
+QString IconDownloadScheduler::cacheFilePath(const QString& domain, const QByteArray& salt) const
+{
+    // Name the files by a salted hash of the domain. The salt keeps the names from being looked up
+    // in a precomputed table of domain hashes, but anyone who can read the cache directory can
+    // still test guessed domains against them.
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(salt);
+    hash.addData(domain.toUtf8());
+    return QDir(m_cacheDir).filePath(QString::fromLatin1(hash.result().toHex()) + ".png");
+}
+
+QImage IconDownloadScheduler::cachedIcon(const QString& domain) const
+{
+    if (m_cacheDir.isEmpty()) {
+        return {};
+    }
+
+    const auto salt = cacheSalt(false);
+    if (salt.isEmpty()) {
+        return {};
+    }
+
+    const QFileInfo info(cacheFilePath(domain, salt));
+    if (!info.exists() || info.lastModified().toUTC().daysTo(Clock::currentDateTimeUtc()) > CacheMaxAgeDays) {
+        return {};
+    }
+    return QImage(info.filePath());
+}
+
+void IconDownloadScheduler::storeIcon(const QString& domain, const QImage& image) const
+{
+    if (m_cacheDir.isEmpty() || !QDir().mkpath(m_cacheDir)) {
+        return;
+    }
+
+    const auto salt = cacheSalt(true);
+    if (!salt.isEmpty()) {
+        image.save(cacheFilePath(domain, salt), "PNG");
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ICONDOWNLOADSCHEDULER_H
+#define KEEPASSXC_ICONDOWNLOADSCHEDULER_H
+
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QQueue>
+#include <QStringList>
+
+class IconDownloader;
+
+/**
+ * Downloads favicons for many URLs at once.
+ *
+ * URLs sharing a registrable domain are fetched only once, at most a fixed
+ * number of downloads run at the same time. If a cache directory is set,
+ * icons found earlier are taken from it. The finished() signal is emitted
+ * once for every queued URL, with a null image if no icon was found.
+ */
+class IconDownloadScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IconDownloadScheduler(QObject* parent = nullptr);
+    ~IconDownloadScheduler() override;
+
+    void setMaxConcurrentDownloads(int count);
+    int maxConcurrentDownloads() const;
+    void setCacheDirectory(const QString& path);
+    QString cacheDirectory() const;
+    static QString defaultCacheDirectory();
+    static bool clearCache(const QString& path);
+
+    void enqueue(const QString& url);
+    int pendingCount() const;
+    int activeDownloads() const;
+
+signals:
+    void finished(const QString& url, const QImage& image);
+
+public slots:
+    void abort();
+
+private slots:
+    void scheduleDownloads();
+    void downloadFinished(const QString& url, const QImage& image);
+
+private:
+    void requestScheduling();
+    void finishDomain(const QString& domain, const QImage& image);
+    QByteArray cacheSalt(bool create) const;
+    QString cacheFilePath(const QString& domain, const QByteArray& salt) const;
+    QImage cachedIcon(const QString& domain) const;
+    void storeIcon(const QString& domain, const QImage& image) const;
+
+    int m_maxConcurrent;
+    QString m_cacheDir;
+    mutable QByteArray m_cacheSalt;
+    QQueue<QString> m_queue;
+    QHash<QString, QStringList> m_urlsByDomain;
+    QHash<IconDownloader*, QString> m_activeDownloads;
+    QStringList m_invalidUrls;
+    int m_pendingCount;
+    bool m_schedulingRequested;
+
+    Q_DISABLE_COPY(IconDownloadScheduler)
+};
+
+#endif // KEEPASSXC_ICONDOWNLOADSCHEDULER_H
@@ -19,7 +19,7 @@
 #include "core/Config.h"
 #include "core/NetworkManager.h"
 
-#include <QHostInfo>
+#include <QHostAddress>
 #include <QImageReader>
 #include <QtNetwork>
 
@@ -68,8 +68,32 @@ namespace
         QUrl url = convertVariantToUrl(var);
         return url;
     }
+
+    bool isIpAddress(const QString& host)
+    {
+        QHostAddress address;
+        return address.setAddress(host);
+    }
 } // namespace
 
+/**
+ * Determine the registrable domain of an entry URL, e.g. "example.co.uk" for
+ * "https://login.example.co.uk/path". IP addresses are returned as is.
+ *
+ * @return the domain or an empty string if the URL has no usable host
+ */
+QString IconDownloader::registrableDomain(const QString& entryUrl)
+{
+    QUrl url = QUrl::fromUserInput(entryUrl);
+    if (!url.isValid() || url.host().isEmpty()) {
+        return {};
+    }
+    if (isIpAddress(url.host()) || url.topLevelDomain().isEmpty()) {
+        return url.host();
+    }
+    return getSecondLevelDomain(url);
+}
+
 void IconDownloader::setUrl(const QString& entryUrl)
 {
     m_url = entryUrl;
@@ -101,14 +125,9 @@ void IconDownloader::setUrl(const QString& entryUrl)
 
     QString fullyQualifiedDomain = url.host();
 
-    // Determine if host portion of URL is an IP address by resolving it and
-    // searching for a match with the returned address(es).
-    bool hostIsIp = false;
-    QList<QHostAddress> hostAddressess = QHostInfo::fromName(fullyQualifiedDomain).addresses();
-    hostIsIp =
-        std::any_of(hostAddressess.begin(), hostAddressess.end(), [&fullyQualifiedDomain](const QHostAddress& addr) {
-            return addr.toString() == fullyQualifiedDomain;
-        });
+    // Determine if host portion of URL is an IP address. This is decided from the
+    // address syntax alone, a blocking name lookup here would stall the caller.
+    const bool hostIsIp = isIpAddress(fullyQualifiedDomain);
 
     // Determine the second-level domain, if available
     QString secondLevelDomain;
@@ -151,6 +170,10 @@ void IconDownloader::setUrl(const QString& entryUrl)
 void IconDownloader::download()
 {
     if (m_urlsToTry.isEmpty()) {
+        // Nothing to fetch for this URL, report it like a failed download once control returns
+        // to the event loop, so callers see the same order of events as for a real download
+        const auto url = m_url;
+        QTimer::singleShot(0, this, [this, url] { emit finished(url, QImage()); });
         return;
     }
 
@@ -166,6 +189,8 @@ void IconDownloader::download()
 
 void IconDownloader::abortDownload()
 {
+    // Give up on the remaining URLs too, otherwise the next one would be fetched
+    m_urlsToTry.clear();
     if (m_reply) {
         m_reply->abort();
     }
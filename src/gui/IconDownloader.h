@@ -38,6 +38,8 @@ public:
     void setUrl(const QString& entryUrl);
     void download();
 
+    static QString registrableDomain(const QString& entryUrl);
+
 signals:
     void finished(const QString& entryUrl, const QImage& image);
 
@@ -25,18 +25,17 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
-#include "gui/IconDownloader.h"
+#include "gui/IconDownloadScheduler.h"
 #include "gui/IconModels.h"
 #ifdef Q_OS_MACOS
 #include "gui/osutils/macutils/MacUtils.h"
 #endif
 
-#include <QMutexLocker>
-
 IconDownloaderDialog::IconDownloaderDialog(QWidget* parent)
     : QDialog(parent)
     , m_ui(new Ui::IconDownloaderDialog())
     , m_dataModel(new QStandardItemModel(this))
+    , m_scheduler(new IconDownloadScheduler(this))
 {
     setWindowFlags(Qt::Window);
     setAttribute(Qt::WA_DeleteOnClose);
@@ -50,6 +49,11 @@ IconDownloaderDialog::IconDownloaderDialog(QWidget* parent)
     m_ui->tableView->setModel(m_dataModel);
     m_ui->tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
 
+    if (config()->get(Config::Security_IconDownloadCache).toBool()) {
+        m_scheduler->setCacheDirectory(IconDownloadScheduler::defaultCacheDirectory());
+    }
+    connect(m_scheduler, &IconDownloadScheduler::finished, this, &IconDownloaderDialog::downloadFinished);
+
     connect(m_ui->cancelButton, SIGNAL(clicked()), SLOT(abortDownloads()));
     connect(m_ui->closeButton, SIGNAL(clicked()), SLOT(close()));
 }
@@ -65,6 +69,7 @@ void IconDownloaderDialog::downloadFavicons(const QSharedPointer<Database>& data
 {
     m_db = database;
     m_urlToEntries.clear();
+    m_statusItems.clear();
     abortDownloads();
     for (const auto& e : entries) {
         // Only consider entries with a valid URL and without a custom icon
@@ -84,62 +89,32 @@ void IconDownloaderDialog::downloadFavicons(const QSharedPointer<Database>& data
         open();
         QApplication::processEvents();
 
+        // The scheduler starts the downloads once control returns to the event loop
         for (const auto& url : m_urlToEntries.uniqueKeys()) {
-            m_dataModel->appendRow(QList<QStandardItem*>()
-                                   << new QStandardItem(url) << new QStandardItem(tr("Downloading…")));
-            m_activeDownloaders.append(createDownloader(url));
+            auto* statusItem = new QStandardItem(tr("Downloading…"));
+            m_dataModel->appendRow(QList<QStandardItem*>() << new QStandardItem(url) << statusItem);
+            m_statusItems.insert(url, statusItem);
+            m_scheduler->enqueue(url);
         }
 
         // Setup the dialog
         updateProgressBar();
         updateCancelButton();
-        QApplication::processEvents();
-
-        // Start the downloads
-        for (auto downloader : m_activeDownloaders) {
-            downloader->download();
-        }
     }
 }
 
-IconDownloader* IconDownloaderDialog::createDownloader(const QString& url)
-{
-    auto downloader = new IconDownloader();
-    connect(downloader,
-            SIGNAL(finished(const QString&, const QImage&)),
-            this,
-            SLOT(downloadFinished(const QString&, const QImage&)));
-
-    downloader->setUrl(url);
-    return downloader;
-}
-
 void IconDownloaderDialog::downloadFinished(const QString& url, const QImage& icon)
 {
-    // Prevent re-entrance from multiple calls finishing at the same time
-    QMutexLocker locker(&m_mutex);
-
-    // Cleanup the icon downloader that sent this signal
-    auto downloader = qobject_cast<IconDownloader*>(sender());
-    if (downloader) {
-        downloader->deleteLater();
-        m_activeDownloaders.removeAll(downloader);
-    }
-
     updateProgressBar();
     updateCancelButton();
 
     if (m_db && !icon.isNull()) {
-        // Don't add an icon larger than 128x128, but retain original size if smaller
-        auto scaledicon = icon;
-        if (icon.width() > 128 || icon.height() > 128) {
-            scaledicon = icon.scaled(128, 128);
-        }
-
-        QUuid uuid = m_db->metadata()->findCustomIcon(scaledicon);
+        // Scale down large icons before they are stored
+        const QImage normalized = Metadata::normalizeCustomIcon(icon);
+        QUuid uuid = m_db->metadata()->findCustomIcon(normalized);
         if (uuid.isNull()) {
             uuid = QUuid::createUuid();
-            m_db->metadata()->addCustomIcon(uuid, scaledicon);
+            m_db->metadata()->addCustomIcon(uuid, normalized);
             updateTable(url, tr("Ok"));
         } else {
             updateTable(url, tr("Already Exists"));
@@ -165,8 +140,8 @@ void IconDownloaderDialog::showFallbackMessage(bool state)
 
 void IconDownloaderDialog::updateProgressBar()
 {
-    int total = m_urlToEntries.uniqueKeys().count();
-    int value = total - m_activeDownloaders.count();
+    int total = m_statusItems.size();
+    int value = total - m_scheduler->pendingCount();
     m_ui->progressBar->setValue(value);
     m_ui->progressBar->setMaximum(total);
     m_ui->progressLabel->setText(
@@ -175,24 +150,20 @@ void IconDownloaderDialog::updateProgressBar()
 
 void IconDownloaderDialog::updateCancelButton()
 {
-    m_ui->cancelButton->setEnabled(!m_activeDownloaders.isEmpty());
+    m_ui->cancelButton->setEnabled(m_scheduler->pendingCount() > 0);
 }
 
 void IconDownloaderDialog::updateTable(const QString& url, const QString& message)
 {
-    for (int i = 0; i < m_dataModel->rowCount(); ++i) {
-        if (m_dataModel->item(i, 0)->text() == url) {
-            m_dataModel->item(i, 1)->setText(message);
-        }
+    auto* statusItem = m_statusItems.value(url);
+    if (statusItem) {
+        statusItem->setText(message);
     }
 }
 
 void IconDownloaderDialog::abortDownloads()
 {
-    for (auto* downloader : m_activeDownloaders) {
-        delete downloader;
-    }
-    m_activeDownloaders.clear();
+    m_scheduler->abort();
     updateProgressBar();
     updateCancelButton();
 }
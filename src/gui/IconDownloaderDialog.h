@@ -19,7 +19,6 @@
 #define KEEPASSX_ICONDOWNLOADERDIALOG_H
 
 #include <QDialog>
-#include <QMutex>
 #include <QStandardItemModel>
 
 #include "gui/MessageWidget.h"
@@ -27,7 +26,7 @@
 class Database;
 class Entry;
 class CustomIconModel;
-class IconDownloader;
+class IconDownloadScheduler;
 
 namespace Ui
 {
@@ -49,8 +48,6 @@ private slots:
     void abortDownloads();
 
 private:
-    IconDownloader* createDownloader(const QString& url);
-
     void showFallbackMessage(bool state);
     void updateTable(const QString& url, const QString& message);
     void updateProgressBar();
@@ -60,8 +57,8 @@ private:
     QStandardItemModel* m_dataModel;
     QSharedPointer<Database> m_db;
     QMultiMap<QString, Entry*> m_urlToEntries;
-    QList<IconDownloader*> m_activeDownloaders;
-    QMutex m_mutex;
+    QHash<QString, QStandardItem*> m_statusItems;
+    IconDownloadScheduler* m_scheduler;
 
     Q_DISABLE_COPY(IconDownloaderDialog)
 };
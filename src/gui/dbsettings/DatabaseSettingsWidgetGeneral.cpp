@@ -25,6 +25,11 @@
 #include "core/Metadata.h"
 #include "gui/MessageBox.h"
 
+namespace
+{
+    constexpr int DefaultDeletedObjectsMaxAge = 365;
+} // namespace
+
 DatabaseSettingsWidgetGeneral::DatabaseSettingsWidgetGeneral(QWidget* parent)
     : DatabaseSettingsWidget(parent)
     , m_ui(new Ui::DatabaseSettingsWidgetGeneral())
@@ -33,6 +38,10 @@ DatabaseSettingsWidgetGeneral::DatabaseSettingsWidgetGeneral(QWidget* parent)
 
     connect(m_ui->historyMaxItemsCheckBox, SIGNAL(toggled(bool)), m_ui->historyMaxItemsSpinBox, SLOT(setEnabled(bool)));
     connect(m_ui->historyMaxSizeCheckBox, SIGNAL(toggled(bool)), m_ui->historyMaxSizeSpinBox, SLOT(setEnabled(bool)));
+    connect(m_ui->deletedObjectsMaxAgeCheckBox,
+            SIGNAL(toggled(bool)),
+            m_ui->deletedObjectsMaxAgeSpinBox,
+            SLOT(setEnabled(bool)));
 }
 
 DatabaseSettingsWidgetGeneral::~DatabaseSettingsWidgetGeneral()
@@ -64,6 +73,14 @@ void DatabaseSettingsWidgetGeneral::initialize()
         m_ui->historyMaxSizeSpinBox->setValue(Metadata::DefaultHistoryMaxSize);
         m_ui->historyMaxSizeCheckBox->setChecked(false);
     }
+    int deletedObjectsMaxAge = m_db->deletedObjectsMaxAge();
+    if (deletedObjectsMaxAge > 0) {
+        m_ui->deletedObjectsMaxAgeSpinBox->setValue(deletedObjectsMaxAge);
+        m_ui->deletedObjectsMaxAgeCheckBox->setChecked(true);
+    } else {
+        m_ui->deletedObjectsMaxAgeSpinBox->setValue(DefaultDeletedObjectsMaxAge);
+        m_ui->deletedObjectsMaxAgeCheckBox->setChecked(false);
+    }
 }
 
 void DatabaseSettingsWidgetGeneral::uninitialize()
@@ -134,6 +151,14 @@ bool DatabaseSettingsWidgetGeneral::save()
         truncate = true;
     }
 
+    int deletedObjectsMaxAge = 0;
+    if (m_ui->deletedObjectsMaxAgeCheckBox->isChecked()) {
+        deletedObjectsMaxAge = m_ui->deletedObjectsMaxAgeSpinBox->value();
+    }
+    if (deletedObjectsMaxAge != m_db->deletedObjectsMaxAge()) {
+        m_db->setDeletedObjectsMaxAge(deletedObjectsMaxAge);
+    }
+
     if (truncate) {
         const QList<Entry*> allEntries = m_db->rootGroup()->entriesRecursive(false);
         for (Entry* entry : allEntries) {
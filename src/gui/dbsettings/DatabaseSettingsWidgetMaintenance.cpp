@@ -39,6 +39,7 @@ DatabaseSettingsWidgetMaintenance::DatabaseSettingsWidgetMaintenance(QWidget* pa
 
     connect(m_ui->deleteButton, SIGNAL(clicked()), SLOT(removeCustomIcon()));
     connect(m_ui->purgeButton, SIGNAL(clicked()), SLOT(purgeUnusedCustomIcons()));
+    connect(m_ui->mergeDuplicatesButton, SIGNAL(clicked()), SLOT(mergeDuplicateCustomIcons()));
     connect(m_ui->customIconsView->selectionModel(),
             SIGNAL(selectionChanged(QItemSelection, QItemSelection)),
             this,
@@ -224,3 +225,27 @@ void DatabaseSettingsWidgetMaintenance::purgeUnusedCustomIcons()
     MessageBox::information(
         this, tr("Purged Unused Icons"), tr("Purged %n icon(s) from the database.", "", purgeCounter), MessageBox::Ok);
 }
+
+void DatabaseSettingsWidgetMaintenance::mergeDuplicateCustomIcons()
+{
+    auto database = DatabaseSettingsWidget::getDatabase();
+    if (!database) {
+        return;
+    }
+
+    const int mergeCounter = database->mergeDuplicateCustomIcons();
+    if (0 == mergeCounter) {
+        MessageBox::information(this,
+                                tr("No Duplicate Icons"),
+                                tr("All custom icons in the database are distinct."),
+                                MessageBox::Ok);
+        return;
+    }
+
+    populateIcons(database);
+
+    MessageBox::information(this,
+                            tr("Merged Duplicate Icons"),
+                            tr("Merged %n duplicate icon(s).", "", mergeCounter),
+                            MessageBox::Ok);
+}
@@ -56,6 +56,7 @@ private slots:
     void selectionChanged();
     void removeCustomIcon();
     void purgeUnusedCustomIcons();
+    void mergeDuplicateCustomIcons();
 
 private:
     void populateIcons(QSharedPointer<Database> db);
@@ -43,6 +43,7 @@
 #include "core/Entry.h"
 #include "core/Metadata.h"
 #include "core/PasswordHealth.h"
+#include "core/TagIndex.h"
 #include "core/TimeDelta.h"
 #include "core/Tools.h"
 #ifdef WITH_XC_SSHAGENT
@@ -66,6 +67,37 @@
 #include "gui/entry/EntryAttributesModel.h"
 #include "gui/entry/EntryHistoryModel.h"
 
+namespace
+{
+    // Completes the tag being typed and keeps the tags before it
+    class TagsCompleter : public QCompleter
+    {
+    public:
+        explicit TagsCompleter(QObject* parent)
+            : QCompleter(parent)
+        {
+        }
+
+        QStringList splitPath(const QString& path) const override
+        {
+            return {path.mid(lastSeparator(path) + 1).trimmed()};
+        }
+
+        QString pathFromIndex(const QModelIndex& index) const override
+        {
+            const auto* edit = qobject_cast<QLineEdit*>(widget());
+            const auto text = edit ? edit->text() : QString();
+            return text.left(lastSeparator(text) + 1) + QCompleter::pathFromIndex(index);
+        }
+
+    private:
+        static int lastSeparator(const QString& text)
+        {
+            return qMax(text.lastIndexOf(';'), text.lastIndexOf(','));
+        }
+    };
+} // namespace
+
 EditEntryWidget::EditEntryWidget(QWidget* parent)
     : EditWidget(parent)
     , m_entry(nullptr)
@@ -100,6 +132,8 @@ EditEntryWidget::EditEntryWidget(QWidget* parent)
     , m_autoTypeWindowSequenceGroup(new QButtonGroup(this))
     , m_usernameCompleter(new QCompleter(this))
     , m_usernameCompleterModel(new QStringListModel(this))
+    , m_tagsCompleter(new TagsCompleter(this))
+    , m_tagsCompleterModel(new QStringListModel(this))
 {
     setupMain();
     setupAdvanced();
@@ -155,6 +189,10 @@ void EditEntryWidget::setupMain()
     m_usernameCompleter->setModel(m_usernameCompleterModel);
     m_mainUi->usernameComboBox->setCompleter(m_usernameCompleter);
 
+    m_tagsCompleter->setCaseSensitivity(Qt::CaseInsensitive);
+    m_tagsCompleter->setModel(m_tagsCompleterModel);
+    m_mainUi->tagsEdit->setCompleter(m_tagsCompleter);
+
 #ifdef WITH_XC_NETWORKING
     m_mainUi->fetchFaviconButton->setIcon(icons()->icon("favicon-download"));
     m_mainUi->fetchFaviconButton->setDisabled(true);
@@ -430,6 +468,7 @@ void EditEntryWidget::setupEntryUpdate()
     connect(m_mainUi->usernameComboBox->lineEdit(), SIGNAL(textChanged(QString)), this, SLOT(setModified()));
     connect(m_mainUi->passwordEdit, SIGNAL(textChanged(QString)), this, SLOT(setModified()));
     connect(m_mainUi->urlEdit, SIGNAL(textChanged(QString)), this, SLOT(setModified()));
+    connect(m_mainUi->tagsEdit, SIGNAL(textChanged(QString)), this, SLOT(setModified()));
 #ifdef WITH_XC_NETWORKING
     connect(m_mainUi->urlEdit, SIGNAL(textChanged(QString)), this, SLOT(updateFaviconButtonEnable(QString)));
 #endif
@@ -841,6 +880,7 @@ void EditEntryWidget::setForms(Entry* entry, bool restore)
     m_mainUi->titleEdit->setReadOnly(m_history);
     m_mainUi->usernameComboBox->lineEdit()->setReadOnly(m_history);
     m_mainUi->urlEdit->setReadOnly(m_history);
+    m_mainUi->tagsEdit->setReadOnly(m_history);
     m_mainUi->passwordEdit->setReadOnly(m_history);
     m_mainUi->expireCheck->setEnabled(!m_history);
     m_mainUi->expireDatePicker->setReadOnly(m_history);
@@ -878,6 +918,8 @@ void EditEntryWidget::setForms(Entry* entry, bool restore)
     m_mainUi->titleEdit->setText(entry->title());
     m_mainUi->usernameComboBox->lineEdit()->setText(entry->username());
     m_mainUi->urlEdit->setText(entry->url());
+    m_mainUi->tagsEdit->setText(entry->tags());
+    m_tagsCompleterModel->setStringList(m_db->tagIndex()->tags());
     m_mainUi->passwordEdit->setText(entry->password());
     m_mainUi->passwordEdit->setShowPassword(!config()->get(Config::Security_PasswordsHidden).toBool());
     if (!m_history) {
@@ -1123,6 +1165,9 @@ void EditEntryWidget::updateEntryData(Entry* entry) const
     entry->setTitle(m_mainUi->titleEdit->text().replace(newLineRegex, " "));
     entry->setUsername(m_mainUi->usernameComboBox->lineEdit()->text().replace(newLineRegex, " "));
     entry->setUrl(m_mainUi->urlEdit->text().replace(newLineRegex, " "));
+    if (m_mainUi->tagsEdit->text() != entry->tags()) {
+        entry->setTags(TagIndex::splitTags(m_mainUi->tagsEdit->text()).join(";"));
+    }
     entry->setPassword(m_mainUi->passwordEdit->text());
     entry->setExpires(m_mainUi->expireCheck->isChecked());
     entry->setExpiryTime(m_mainUi->expireDatePicker->dateTime().toUTC());
@@ -1217,6 +1262,8 @@ void EditEntryWidget::clear()
     m_mainUi->titleEdit->setText("");
     m_mainUi->passwordEdit->setText("");
     m_mainUi->urlEdit->setText("");
+    m_mainUi->tagsEdit->clear();
+    m_tagsCompleterModel->setStringList({});
     m_mainUi->notesEdit->clear();
 
     m_entryAttributes->clear();
@@ -200,6 +200,8 @@ private:
     QButtonGroup* const m_autoTypeWindowSequenceGroup;
     QCompleter* const m_usernameCompleter;
     QStringListModel* const m_usernameCompleterModel;
+    QCompleter* const m_tagsCompleter;
+    QStringListModel* const m_tagsCompleterModel;
     QTimer m_entryModifiedTimer;
 
     Q_DISABLE_COPY(EditEntryWidget)
@@ -8,16 +8,33 @@
 #include <QFileInfo>
 #include <QMimeData>
 #include <QProcessEnvironment>
+#include <QProgressDialog>
 #include <QTemporaryFile>
 
 #include "EntryAttachmentsModel.h"
 #include "config-keepassx.h"
 #include "core/Config.h"
 #include "core/EntryAttachments.h"
-#include "core/Tools.h"
 #include "gui/FileDialog.h"
 #include "gui/MessageBox.h"
 
+namespace
+{
+    /**
+     * Report the progress of copying an attachment to a dialog, which also lets the user cancel.
+     * The dialog only shows up if copying takes a while.
+     */
+    EntryAttachments::ProgressCallback progressCallback(QProgressDialog* dialog)
+    {
+        return [dialog](qint64 done, qint64 total) {
+            if (total > 0) {
+                dialog->setValue(static_cast<int>(done * dialog->maximum() / total));
+            }
+            return !dialog->wasCanceled();
+        };
+    }
+} // namespace
+
 EntryAttachmentsWidget::EntryAttachmentsWidget(QWidget* parent)
     : QWidget(parent)
     , m_ui(new Ui::EntryAttachmentsWidget)
@@ -243,12 +260,26 @@ void EntryAttachmentsWidget::saveSelectedAttachments()
             }
         }
 
+        // Created after asking about overwriting, so it does not show up while asking
+        QProgressDialog progress(tr("Saving %1…").arg(filename), tr("Cancel"), 0, 100, this);
+        progress.setWindowModality(Qt::WindowModal);
+        progress.setMinimumDuration(500);
+
         QFile file(attachmentPath);
-        const QByteArray attachmentData = m_entryAttachments->value(filename);
+        QString errorMessage;
         const bool saveOk = file.open(QIODevice::WriteOnly) && file.setPermissions(QFile::ReadUser | QFile::WriteUser)
-                            && file.write(attachmentData) == attachmentData.size();
+                            && m_entryAttachments->exportAttachment(
+                                filename, &file, &errorMessage, progressCallback(&progress));
+        if (!saveOk && file.isOpen()) {
+            // Don't leave partially written files behind
+            file.remove();
+        }
+        if (progress.wasCanceled()) {
+            break;
+        }
         if (!saveOk) {
-            errors.append(QString("%1 - %2").arg(filename, file.errorString()));
+            const QString reason = errorMessage.isEmpty() ? file.errorString() : errorMessage;
+            errors.append(QString("%1 - %2").arg(filename, reason));
         }
     }
 
@@ -316,18 +347,31 @@ bool EntryAttachmentsWidget::insertAttachments(const QStringList& filenames, QSt
         return false;
     }
 
+    QProgressDialog progress(this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    progress.setRange(0, 100);
+
     QStringList errors;
     for (const QString& filename : filenames) {
-        QByteArray data;
         QFile file(filename);
         const QFileInfo fInfo(filename);
-        const bool readOk = file.open(QIODevice::ReadOnly) && Tools::readAllFromDevice(&file, data);
-        if (readOk) {
-            m_entryAttachments->set(fInfo.fileName(), data);
-        } else {
-            errors.append(QString("%1 - %2").arg(fInfo.fileName(), file.errorString()));
+        progress.setLabelText(tr("Adding %1…").arg(fInfo.fileName()));
+        progress.setValue(0);
+
+        QString readError;
+        const bool readOk =
+            file.open(QIODevice::ReadOnly)
+            && m_entryAttachments->importAttachment(fInfo.fileName(), &file, &readError, progressCallback(&progress));
+        if (progress.wasCanceled()) {
+            break;
+        }
+        if (!readOk) {
+            const QString reason = readError.isEmpty() ? file.errorString() : readError;
+            errors.append(QString("%1 - %2").arg(fInfo.fileName(), reason));
         }
     }
+    progress.reset();
 
     if (!errors.isEmpty()) {
         errorMessage = tr("Unable to open file(s):\n%1", "", errors.size()).arg(errors.join('\n'));
@@ -339,7 +383,6 @@ bool EntryAttachmentsWidget::insertAttachments(const QStringList& filenames, QSt
 bool EntryAttachmentsWidget::openAttachment(const QModelIndex& index, QString& errorMessage)
 {
     const QString filename = m_attachmentsModel->keyByIndex(index);
-    const QByteArray attachmentData = m_entryAttachments->value(filename);
 
     // tmp file will be removed once the database (or the application) has been closed
 #ifdef KEEPASSXC_DIST_SNAP
@@ -351,9 +394,18 @@ bool EntryAttachmentsWidget::openAttachment(const QModelIndex& index, QString& e
 
     QScopedPointer<QTemporaryFile> tmpFile(new QTemporaryFile(tmpFileTemplate, this));
 
-    const bool saveOk = tmpFile->open() && tmpFile->write(attachmentData) == attachmentData.size() && tmpFile->flush();
+    QProgressDialog progress(tr("Opening %1…").arg(filename), tr("Cancel"), 0, 100, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+
+    QString saveError;
+    const bool saveOk = tmpFile->open()
+                        && m_entryAttachments->exportAttachment(
+                            filename, tmpFile.data(), &saveError, progressCallback(&progress))
+                        && tmpFile->flush();
+    progress.reset();
     if (!saveOk) {
-        errorMessage = QString("%1 - %2").arg(filename, tmpFile->errorString());
+        errorMessage = QString("%1 - %2").arg(filename, saveError.isEmpty() ? tmpFile->errorString() : saveError);
         return false;
     }
 
@@ -22,6 +22,7 @@
 #include <QPainter>
 #include <QPalette>
 
+#include "core/Database.h"
 #include "core/DatabaseIcons.h"
 #include "core/Entry.h"
 #include "core/Group.h"
@@ -71,6 +72,7 @@ void EntryModel::setGroup(Group* group)
     m_orgEntries.clear();
 
     makeConnections(group);
+    connectDatabase(group->database());
 
     endResetModel();
 }
@@ -102,6 +104,8 @@ void EntryModel::setEntries(const QList<Entry*>& entries)
         if (db->metadata()->recycleBin()) {
             m_allGroups.removeOne(db->metadata()->recycleBin());
         }
+
+        connectDatabase(db);
     }
 
     for (const Group* group : asConst(m_allGroups)) {
@@ -567,9 +571,41 @@ void EntryModel::entryMovedDown()
 void EntryModel::entryDataChanged(Entry* entry)
 {
     int row = m_entries.indexOf(entry);
+    if (row == -1) {
+        // Expiry is reported for all entries of the database
+        return;
+    }
     emit dataChanged(index(row, 0), index(row, columnCount() - 1));
 }
 
+void EntryModel::entriesAboutToBeTaken(Group* group)
+{
+    QList<Entry*> remaining;
+    if (!m_group) {
+        for (Entry* entry : asConst(m_entries)) {
+            if (entry->group() != group) {
+                remaining.append(entry);
+            }
+        }
+        if (remaining.size() == m_entries.size()) {
+            return;
+        }
+    }
+
+    // A single reset is much cheaper than removing the rows one by one
+    beginResetModel();
+    m_entries = remaining;
+    if (!m_group) {
+        QMutableListIterator<Entry*> i(m_orgEntries);
+        while (i.hasNext()) {
+            if (i.next()->group() == group) {
+                i.remove();
+            }
+        }
+    }
+    endResetModel();
+}
+
 void EntryModel::onConfigChanged(Config::ConfigKey key)
 {
     switch (key) {
@@ -593,6 +629,13 @@ void EntryModel::severConnections()
     for (const Group* group : asConst(m_allGroups)) {
         disconnect(group, nullptr, this, nullptr);
     }
+
+    for (const auto& db : asConst(m_databases)) {
+        if (db) {
+            disconnect(db, nullptr, this, nullptr);
+        }
+    }
+    m_databases.clear();
 }
 
 void EntryModel::makeConnections(const Group* group)
@@ -606,4 +649,16 @@ void EntryModel::makeConnections(const Group* group)
     connect(group, SIGNAL(entryAboutToMoveDown(int)), SLOT(entryAboutToMoveDown(int)));
     connect(group, SIGNAL(entryMovedDown()), SLOT(entryMovedDown()));
     connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
+    connect(group, SIGNAL(entriesAboutToBeTaken(Group*)), SLOT(entriesAboutToBeTaken(Group*)));
+}
+
+/**
+ * Redraw entries as they expire, the database schedules their expiry times.
+ */
+void EntryModel::connectDatabase(Database* db)
+{
+    if (db) {
+        connect(db, SIGNAL(entryExpired(Entry*)), SLOT(entryDataChanged(Entry*)));
+        m_databases.append(db);
+    }
 }
@@ -20,9 +20,11 @@
 
 #include <QAbstractTableModel>
 #include <QPixmap>
+#include <QPointer>
 
 #include "core/Config.h"
 
+class Database;
 class Entry;
 class Group;
 
@@ -77,17 +79,20 @@ private slots:
     void entryAboutToMoveDown(int row);
     void entryMovedDown();
     void entryDataChanged(Entry* entry);
+    void entriesAboutToBeTaken(Group* group);
 
     void onConfigChanged(Config::ConfigKey key);
 
 private:
     void severConnections();
     void makeConnections(const Group* group);
+    void connectDatabase(Database* db);
 
     Group* m_group;
     QList<Entry*> m_entries;
     QList<Entry*> m_orgEntries;
     QList<const Group*> m_allGroups;
+    QList<QPointer<Database>> m_databases;
 
     const QString HiddenContentDisplay;
     const Qt::DateFormat DateFormat;
@@ -48,6 +48,8 @@ void GroupModel::changeDatabase(Database* newDb)
     connect(m_db, SIGNAL(groupRemoved()), SLOT(groupRemoved()));
     connect(m_db, SIGNAL(groupAboutToMove(Group*,Group*,int)), SLOT(groupAboutToMove(Group*,Group*,int)));
     connect(m_db, SIGNAL(groupMoved()), SLOT(groupMoved()));
+    connect(m_db, SIGNAL(groupChildrenAboutToBeTaken(Group*)), SLOT(groupChildrenAboutToBeTaken(Group*)));
+    connect(m_db, SIGNAL(groupChildrenTaken()), SLOT(groupChildrenTaken()));
     // clang-format on
 
     endResetModel();
@@ -422,6 +424,18 @@ void GroupModel::groupMoved()
     endMoveRows();
 }
 
+void GroupModel::groupChildrenAboutToBeTaken(Group* group)
+{
+    Q_ASSERT(!group->children().isEmpty());
+
+    beginRemoveRows(index(group), 0, group->children().size() - 1);
+}
+
+void GroupModel::groupChildrenTaken()
+{
+    endRemoveRows();
+}
+
 void GroupModel::sortChildren(Group* rootGroup, bool reverse)
 {
     emit layoutAboutToBeChanged();
@@ -59,6 +59,8 @@ private slots:
     void groupAdded();
     void groupAboutToMove(Group* group, Group* toGroup, int pos);
     void groupMoved();
+    void groupChildrenAboutToBeTaken(Group* group);
+    void groupChildrenTaken();
 
 private:
     Database* m_db;
@@ -20,138 +20,14 @@
 
 #include "core/AsyncTask.h"
 #include "core/Database.h"
-#include "core/Global.h"
-#include "core/Group.h"
+#include "core/DatabaseStatistics.h"
 #include "core/Metadata.h"
-#include "core/PasswordHealth.h"
+#include "core/Tools.h"
 #include "gui/Icons.h"
 
+#include <QFileInfo>
 #include <QStandardItemModel>
 
-namespace
-{
-    class Stats
-    {
-    public:
-        // The statistics we collect:
-        QDateTime modified; // File modification time
-        int groupCount = 0; // Number of groups in the database
-        int entryCount = 0; // Number of entries (across all groups)
-        int expiredEntries = 0; // Number of expired entries
-        int excludedEntries = 0; // Number of known bad entries
-        int weakPasswords = 0; // Number of weak or poor passwords
-        int shortPasswords = 0; // Number of passwords 8 characters or less in size
-        int uniquePasswords = 0; // Number of unique passwords
-        int reusedPasswords = 0; // Number of non-unique passwords
-        int totalPasswordLength = 0; // Total length of all passwords
-
-        // Ctor does all the work
-        explicit Stats(QSharedPointer<Database> db)
-            : modified(QFileInfo(db->filePath()).lastModified())
-            , m_db(db)
-        {
-            gatherStats(db->rootGroup()->groupsRecursive(true));
-        }
-
-        // Get average password length
-        int averagePwdLength() const
-        {
-            const auto passwords = uniquePasswords + reusedPasswords;
-            return passwords == 0 ? 0 : std::round(totalPasswordLength / double(passwords));
-        }
-
-        // Get max number of password reuse (=how many entries
-        // share the same password)
-        int maxPwdReuse() const
-        {
-            int ret = 0;
-            for (const auto& count : m_passwords) {
-                ret = std::max(ret, count);
-            }
-            return ret;
-        }
-
-        // A warning sign is displayed if one of the
-        // following returns true.
-        bool isAnyExpired() const
-        {
-            return expiredEntries > 0;
-        }
-
-        bool areTooManyPwdsReused() const
-        {
-            return reusedPasswords > uniquePasswords / 10;
-        }
-
-        bool arePwdsReusedTooOften() const
-        {
-            return maxPwdReuse() > 3;
-        }
-
-        bool isAvgPwdTooShort() const
-        {
-            return averagePwdLength() < 10;
-        }
-
-    private:
-        QSharedPointer<Database> m_db;
-        QHash<QString, int> m_passwords;
-
-        void gatherStats(const QList<Group*>& groups)
-        {
-            auto checker = HealthChecker(m_db);
-
-            for (const auto* group : groups) {
-                // Don't count anything in the recycle bin
-                if (group->isRecycled()) {
-                    continue;
-                }
-
-                ++groupCount;
-
-                for (const auto* entry : group->entries()) {
-                    // Don't count anything in the recycle bin
-                    if (entry->isRecycled()) {
-                        continue;
-                    }
-
-                    ++entryCount;
-
-                    if (entry->isExpired()) {
-                        ++expiredEntries;
-                    }
-
-                    // Get password statistics
-                    const auto pwd = entry->password();
-                    if (!pwd.isEmpty()) {
-                        if (!m_passwords.contains(pwd)) {
-                            ++uniquePasswords;
-                        } else {
-                            ++reusedPasswords;
-                        }
-
-                        if (pwd.size() < 8) {
-                            ++shortPasswords;
-                        }
-
-                        // Speed up Zxcvbn process by excluding very long passwords and most passphrases
-                        if (pwd.size() < 25 && checker.evaluate(entry)->quality() <= PasswordHealth::Quality::Weak) {
-                            ++weakPasswords;
-                        }
-
-                        if (entry->excludeFromReports()) {
-                            ++excludedEntries;
-                        }
-
-                        totalPasswordLength += pwd.size();
-                        m_passwords[pwd]++;
-                    }
-                }
-            }
-        }
-    };
-} // namespace
-
 ReportsWidgetStatistics::ReportsWidgetStatistics(QWidget* parent)
     : QWidget(parent)
     , m_ui(new Ui::ReportsWidgetStatistics())
@@ -206,49 +82,75 @@ void ReportsWidgetStatistics::showEvent(QShowEvent* event)
 
 void ReportsWidgetStatistics::calculateStats()
 {
-    const QScopedPointer<Stats> stats(AsyncTask::runAndWaitForFuture([this] { return new Stats(m_db); }));
+    // All figures except the password ratings are kept up to date by the database
+    auto* stats = m_db->statistics();
+    // Only the entropy estimation runs in the background, on a copy of the passwords,
+    // so edits made while waiting cannot race with it
+    const QStringList unrated = stats->unratedPasswords();
+    stats->addPasswordRatings(
+        AsyncTask::runAndWaitForFuture([unrated] { return DatabaseStatistics::ratePasswords(unrated); }));
+    const int weakPasswords = stats->weakPasswords();
+    const int expiredEntries = stats->expiredEntries();
+    const int uniquePasswords = stats->uniquePasswords();
+    const int reusedPasswords = stats->reusedPasswords();
+    const int maxPasswordReuse = stats->maxPasswordReuse();
+    const int shortPasswords = stats->shortPasswords();
+    const int excludedEntries = stats->excludedEntries();
+    const int averagePasswordLength = stats->averagePasswordLength();
 
     m_referencesModel->clear();
     addStatsRow(tr("Database name"), m_db->metadata()->name());
     addStatsRow(tr("Description"), m_db->metadata()->description());
     addStatsRow(tr("Location"), m_db->filePath());
-    addStatsRow(tr("Last saved"), stats->modified.toString(Qt::DefaultLocaleShortDate));
+    addStatsRow(tr("Last saved"), QFileInfo(m_db->filePath()).lastModified().toString(Qt::DefaultLocaleShortDate));
     addStatsRow(tr("Unsaved changes"),
                 m_db->isModified() ? tr("yes") : tr("no"),
                 m_db->isModified(),
                 tr("The database was modified, but the changes have not yet been saved to disk."));
-    addStatsRow(tr("Number of groups"), QString::number(stats->groupCount));
-    addStatsRow(tr("Number of entries"), QString::number(stats->entryCount));
+    addStatsRow(tr("Number of groups"), QString::number(stats->groupCount()));
+    addStatsRow(tr("Number of entries"), QString::number(stats->entryCount()));
     addStatsRow(tr("Number of expired entries"),
-                QString::number(stats->expiredEntries),
-                stats->isAnyExpired(),
+                QString::number(expiredEntries),
+                expiredEntries > 0,
                 tr("The database contains entries that have expired."));
-    addStatsRow(tr("Unique passwords"), QString::number(stats->uniquePasswords));
+    addStatsRow(tr("Unique passwords"), QString::number(uniquePasswords));
     addStatsRow(tr("Non-unique passwords"),
-                QString::number(stats->reusedPasswords),
-                stats->areTooManyPwdsReused(),
+                QString::number(reusedPasswords),
+                reusedPasswords > uniquePasswords / 10,
                 tr("More than 10% of passwords are reused. Use unique passwords when possible."));
     addStatsRow(tr("Maximum password reuse"),
-                QString::number(stats->maxPwdReuse()),
-                stats->arePwdsReusedTooOften(),
+                QString::number(maxPasswordReuse),
+                maxPasswordReuse > 3,
                 tr("Some passwords are used more than three times. Use unique passwords when possible."));
     addStatsRow(tr("Number of short passwords"),
-                QString::number(stats->shortPasswords),
-                stats->shortPasswords > 0,
+                QString::number(shortPasswords),
+                shortPasswords > 0,
                 tr("Recommended minimum password length is at least 8 characters."));
     addStatsRow(tr("Number of weak passwords"),
-                QString::number(stats->weakPasswords),
-                stats->weakPasswords > 0,
+                QString::number(weakPasswords),
+                weakPasswords > 0,
                 tr("Recommend using long, randomized passwords with a rating of 'good' or 'excellent'."));
     addStatsRow(tr("Entries excluded from reports"),
-                QString::number(stats->excludedEntries),
-                stats->excludedEntries > 0,
+                QString::number(excludedEntries),
+                excludedEntries > 0,
                 tr("Excluding entries from reports, e. g. because they are known to have a poor password, isn't "
                    "necessarily a problem but you should keep an eye on them."));
     addStatsRow(tr("Average password length"),
-                tr("%1 characters").arg(stats->averagePwdLength()),
-                stats->isAvgPwdTooShort(),
+                tr("%1 characters").arg(averagePasswordLength),
+                averagePasswordLength < 10,
                 tr("Average password length is less than ten characters. Longer passwords provide more security."));
+    addStatsRow(tr("Size of entries"), Tools::humanReadableFileSize(stats->entriesSize()));
+    addStatsRow(tr("Size of history"), Tools::humanReadableFileSize(stats->historySize()));
+
+    const auto memory = stats->memoryUsage();
+    addStatsRow(tr("Memory usage (approximate)"), Tools::humanReadableFileSize(memory.total()));
+    addStatsRow(tr("Memory used by entries"), Tools::humanReadableFileSize(memory.entries));
+    addStatsRow(tr("Memory used by history"), Tools::humanReadableFileSize(memory.history));
+    addStatsRow(tr("Memory used by attachments"), Tools::humanReadableFileSize(memory.attachments));
+    addStatsRow(tr("Memory used by icons"), Tools::humanReadableFileSize(memory.icons));
+    addStatsRow(tr("Memory used by custom data"), Tools::humanReadableFileSize(memory.customData));
+    addStatsRow(tr("Memory used by groups"), Tools::humanReadableFileSize(memory.groups));
+    addStatsRow(tr("Memory used by deleted objects"), Tools::humanReadableFileSize(memory.deletedObjects));
 }
 
 void ReportsWidgetStatistics::saveSettings()
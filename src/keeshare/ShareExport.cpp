@@ -18,6 +18,7 @@
 #include "config-keepassx.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "crypto/kdf/KdfScheduler.h"
 #include "format/KeePass2Writer.h"
 #include "keeshare/KeeShare.h"
 #include "keeshare/Signature.h"
@@ -78,11 +79,17 @@ namespace
             const bool updateTimeinfoEntry = targetEntry->canUpdateTimeinfo();
             targetEntry->setUpdateTimeinfo(false);
             targetEntry->setGroup(targetRoot);
-            targetEntry->setUpdateTimeinfo(updateTimeinfoEntry);
             const auto iconUuid = targetEntry->iconUuid();
             if (!iconUuid.isNull() && !targetMetadata->hasCustomIcon(iconUuid)) {
-                targetMetadata->addCustomIcon(iconUuid, sourceEntry->icon());
+                // Share one copy of icons that only differ by uuid
+                const auto existingUuid = targetMetadata->findCustomIcon(sourceEntry->icon());
+                if (existingUuid.isNull()) {
+                    targetMetadata->addCustomIcon(iconUuid, sourceEntry->icon());
+                } else {
+                    targetEntry->setIcon(existingUuid);
+                }
             }
+            targetEntry->setUpdateTimeinfo(updateTimeinfoEntry);
         }
 
         targetDb->setKey(key);
@@ -221,6 +228,9 @@ ShareObserver::Result ShareExport::intoContainer(const QString& resolvedPath,
                                                  const KeeShareSettings::Reference& reference,
                                                  const Group* group)
 {
+    // Exports must not delay unlocking or saving of open databases, closing the database cancels them
+    KdfScheduler::PriorityScope priority(KdfScheduler::Priority::Background, group->database());
+
     QScopedPointer<Database> targetDb(extractIntoDatabase(reference, group));
     const QFileInfo info(resolvedPath);
     if (KeeShare::isContainerType(info, KeeShare::signedContainerFileType())) {
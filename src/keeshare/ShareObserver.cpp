@@ -21,11 +21,13 @@
 #include "core/FileWatcher.h"
 #include "core/Global.h"
 #include "core/Group.h"
+#include "core/Tracing.h"
 #include "keeshare/KeeShare.h"
 #include "keeshare/ShareExport.h"
 #include "keeshare/ShareImport.h"
 
 #include <QDir>
+#include <QSet>
 
 namespace
 {
@@ -48,6 +50,7 @@ ShareObserver::ShareObserver(QSharedPointer<Database> db, QObject* parent)
     connect(m_db.data(), &Database::groupDataChanged, this, &ShareObserver::handleDatabaseChanged);
     connect(m_db.data(), &Database::groupAdded, this, &ShareObserver::handleDatabaseChanged);
     connect(m_db.data(), &Database::groupRemoved, this, &ShareObserver::handleDatabaseChanged);
+    connect(m_db.data(), &Database::groupChildrenTaken, this, &ShareObserver::handleDatabaseChanged);
 
     connect(m_db.data(), &Database::modified, this, &ShareObserver::handleDatabaseChanged);
     connect(m_db.data(), &Database::databaseSaved, this, &ShareObserver::handleDatabaseSaved);
@@ -68,8 +71,23 @@ void ShareObserver::deinitialize()
 
 void ShareObserver::reinitialize()
 {
+    const QList<Group*> groups = m_db->rootGroup()->groupsRecursive(true);
+
+    // Forget the shares of groups that are no longer part of the database
+    const QSet<Group*> currentGroups = groups.toSet();
+    for (auto it = m_groupToReference.begin(); it != m_groupToReference.end();) {
+        if (it.key() && currentGroups.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        const auto resolvedPath = resolvePath(it.value().path, m_db);
+        m_shareToGroup.remove(resolvedPath);
+        m_fileWatchers.remove(resolvedPath);
+        it = m_groupToReference.erase(it);
+    }
+
     QList<QPair<QPointer<Group>, KeeShareSettings::Reference>> shares;
-    for (Group* group : m_db->rootGroup()->groupsRecursive(true)) {
+    for (Group* group : groups) {
         auto oldReference = m_groupToReference.value(group);
         auto newReference = KeeShare::referenceOf(group);
         if (oldReference == newReference) {
@@ -174,6 +192,7 @@ void ShareObserver::notifyAbout(const QStringList& success, const QStringList& w
 
 void ShareObserver::handleDatabaseChanged()
 {
+    Tracing::Span span("ShareObserver::handleDatabaseChanged", "keeshare");
     if (!m_db) {
         Q_ASSERT(m_db);
         return;
@@ -215,6 +234,7 @@ void ShareObserver::handleFileUpdated(const QString& path)
 
 ShareObserver::Result ShareObserver::importShare(const QString& path)
 {
+    Tracing::Span span("ShareObserver::importShare", "keeshare");
     if (!KeeShare::active().in) {
         return {};
     }
@@ -247,6 +267,7 @@ QSharedPointer<Database> ShareObserver::database()
 
 QList<ShareObserver::Result> ShareObserver::exportShares()
 {
+    Tracing::Span span("ShareObserver::exportShares", "keeshare");
     QList<Result> results;
     struct Reference
     {
@@ -20,13 +20,12 @@
 #define KPXC_CHALLENGE_RESPONSE_KEY_H
 
 #include "Key.h"
+#include "core/SecureArena.h"
 #include "drivers/YubiKey.h"
 
 #include <QByteArray>
 #include <QUuid>
 
-#include <botan/secmem.h>
-
 class ChallengeResponseKey : public Key
 {
 public:
@@ -44,7 +43,7 @@ private:
     Q_DISABLE_COPY(ChallengeResponseKey);
 
     QString m_error;
-    Botan::secure_vector<char> m_key;
+    SecureVector<char> m_key;
     YubiKeySlot m_keySlot;
 };
 
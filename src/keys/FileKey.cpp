@@ -24,9 +24,14 @@
 
 #include <QFile>
 
+#include <botan/mem_ops.h>
+#include <cctype>
+
 QUuid FileKey::UUID("a584cbc4-c9b4-437e-81bb-362ca9709273");
 
 constexpr int FileKey::SHA256_SIZE;
+constexpr int FileKey::FORMAT_PREFIX_SIZE;
+constexpr int FileKey::HASH_BUFFER_SIZE;
 
 FileKey::FileKey()
     : Key(UUID)
@@ -67,17 +72,21 @@ bool FileKey::load(QIODevice* device, QString* errorMsg)
         return false;
     }
 
-    // load XML key file v1 or v2
-    QString xmlError;
-    if (loadXml(device, &xmlError)) {
-        return true;
-    }
+    // Detect the key file format from a small prefix so arbitrary (large) files
+    // are only ever read once, during hashing
+    if (looksLikeXml(device->peek(FORMAT_PREFIX_SIZE))) {
+        // load XML key file v1 or v2
+        QString xmlError;
+        if (loadXml(device, &xmlError)) {
+            return true;
+        }
 
-    if (!device->reset() || !xmlError.isEmpty()) {
-        if (errorMsg) {
-            *errorMsg = xmlError;
+        if (!device->reset() || !xmlError.isEmpty()) {
+            if (errorMsg) {
+                *errorMsg = xmlError;
+            }
+            return false;
         }
-        return false;
     }
 
     // try legacy key file formats
@@ -337,6 +346,36 @@ bool FileKey::loadXml(QIODevice* device, QString* errorMsg)
     return ok;
 }
 
+/**
+ * Check whether the given file prefix may start an XML document,
+ * i.e., it begins with a UTF-16 or UTF-32 BOM, or with '<' after an
+ * optional UTF-8 BOM and whitespace. Prefixes that are all whitespace
+ * are treated as XML, the rest of the file decides.
+ *
+ * @param prefix first bytes of the key file
+ * @return true if the key file should be parsed as XML
+ */
+bool FileKey::looksLikeXml(const QByteArray& prefix)
+{
+    // UTF-16 and UTF-32 byte order marks, the XML reader detects the encoding
+    if (prefix.startsWith("\xFF\xFE") || prefix.startsWith("\xFE\xFF")
+        || prefix.startsWith(QByteArray("\x00\x00\xFE\xFF", 4))) {
+        return true;
+    }
+
+    int pos = 0;
+    if (prefix.startsWith("\xEF\xBB\xBF")) {
+        pos = 3;
+    }
+    // Zero bytes are skipped as well, they pad the characters of UTF-16 and UTF-32 without byte order mark
+    while (pos < prefix.size()
+           && (prefix.at(pos) == '\0' || std::isspace(static_cast<unsigned char>(prefix.at(pos))))) {
+        ++pos;
+    }
+    // Whitespace may continue beyond the prefix, let the XML reader decide then
+    return !prefix.isEmpty() && (pos == prefix.size() || prefix.at(pos) == '<');
+}
+
 /**
  * Load fixed 32-bit binary key file.
  *
@@ -350,7 +389,7 @@ bool FileKey::loadBinary(QIODevice* device)
         return false;
     }
 
-    Botan::secure_vector<char> data(32);
+    SecureVector<char> data(32);
     if (device->read(data.data(), 32) != 32 || !device->atEnd()) {
         return false;
     }
@@ -373,12 +412,13 @@ bool FileKey::loadHex(QIODevice* device)
         return false;
     }
 
-    QByteArray data;
-    if (!Tools::readAllFromDevice(device, data) || data.size() != 64) {
+    QByteArray data(64, '\0');
+    if (device->read(data.data(), 64) != 64 || !device->atEnd()) {
         return false;
     }
 
     if (!Tools::isHex(data)) {
+        Botan::secure_scrub_memory(data.data(), static_cast<std::size_t>(data.capacity()));
         return false;
     }
 
@@ -397,6 +437,9 @@ bool FileKey::loadHex(QIODevice* device)
 /**
  * Generate SHA-256 hash of arbitrary text or binary key file.
  *
+ * The file is streamed through a single fixed-size buffer, so memory usage
+ * stays constant regardless of the key file size.
+ *
  * @param device input device
  * @return true on success
  */
@@ -404,15 +447,16 @@ bool FileKey::loadHashed(QIODevice* device)
 {
     CryptoHash cryptoHash(CryptoHash::Sha256);
 
-    QByteArray buffer;
-    do {
-        if (!Tools::readFromDevice(device, buffer)) {
-            return false;
-        }
-        cryptoHash.addData(buffer);
-    } while (!buffer.isEmpty());
+    SecureVector<char> chunk(HASH_BUFFER_SIZE);
+    qint64 readResult;
+    while ((readResult = device->read(chunk.data(), HASH_BUFFER_SIZE)) > 0) {
+        cryptoHash.addData(QByteArray::fromRawData(chunk.data(), static_cast<int>(readResult)));
+    }
+    if (readResult == -1) {
+        return false;
+    }
 
-    buffer = cryptoHash.result();
+    QByteArray buffer = cryptoHash.result();
     std::memcpy(m_key.data(), buffer.data(), std::min(SHA256_SIZE, buffer.size()));
     Botan::secure_scrub_memory(buffer.data(), static_cast<std::size_t>(buffer.capacity()));
 
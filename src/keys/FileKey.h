@@ -20,8 +20,8 @@
 #define KEEPASSX_FILEKEY_H
 
 #include <QXmlStreamReader>
-#include <botan/secmem.h>
 
+#include "core/SecureArena.h"
 #include "keys/Key.h"
 
 class QIODevice;
@@ -53,13 +53,17 @@ public:
 
 private:
     static constexpr int SHA256_SIZE = 32;
+    static constexpr int FORMAT_PREFIX_SIZE = 64;
+    static constexpr int HASH_BUFFER_SIZE = 1024 * 1024;
+
+    static bool looksLikeXml(const QByteArray& prefix);
 
     bool loadXml(QIODevice* device, QString* errorMsg = nullptr);
     bool loadBinary(QIODevice* device);
     bool loadHex(QIODevice* device);
     bool loadHashed(QIODevice* device);
 
-    Botan::secure_vector<char> m_key;
+    SecureVector<char> m_key;
     Type m_type = None;
 };
 
@@ -18,11 +18,10 @@
 #ifndef KEEPASSX_PASSWORDKEY_H
 #define KEEPASSX_PASSWORDKEY_H
 
-#include <botan/secmem.h>
-
 #include <QSharedPointer>
 #include <QString>
 
+#include "core/SecureArena.h"
 #include "keys/Key.h"
 
 class PasswordKey : public Key
@@ -42,7 +41,7 @@ public:
 private:
     static constexpr int SHA256_SIZE = 32;
 
-    Botan::secure_vector<char> m_key;
+    SecureVector<char> m_key;
     bool m_isInitialized = false;
 };
 
@@ -23,7 +23,8 @@
 #include <QMutex>
 #include <QObject>
 #include <QTimer>
-#include <botan/secmem.h>
+
+#include "core/SecureArena.h"
 
 typedef QPair<unsigned int, int> YubiKeySlot;
 Q_DECLARE_METATYPE(YubiKeySlot);
@@ -51,7 +52,7 @@ public:
     QList<YubiKeySlot> foundKeys();
     QString getDisplayName(YubiKeySlot slot);
 
-    ChallengeResult challenge(YubiKeySlot slot, const QByteArray& challenge, Botan::secure_vector<char>& response);
+    ChallengeResult challenge(YubiKeySlot slot, const QByteArray& challenge, SecureVector<char>& response);
     bool testChallenge(YubiKeySlot slot, bool* wouldBlock = nullptr);
 
     QString errorMessage();
@@ -91,7 +92,7 @@ private:
                                      int slot,
                                      bool mayBlock,
                                      const QByteArray& challenge,
-                                     Botan::secure_vector<char>& response);
+                                     SecureVector<char>& response);
     bool performTestChallenge(void* key, int slot, bool* wouldBlock);
 
     QHash<unsigned int, QList<QPair<int, QString>>> m_foundKeys;
@@ -25,6 +25,7 @@
 #include "config-keepassx.h"
 #include "core/Config.h"
 #include "core/Tools.h"
+#include "core/Tracing.h"
 #include "crypto/Crypto.h"
 #include "gui/Application.h"
 #include "gui/MainWindow.h"
@@ -80,12 +81,15 @@ int main(int argc, char** argv)
     QCommandLineOption helpOption = parser.addHelpOption();
     QCommandLineOption versionOption = parser.addVersionOption();
     QCommandLineOption debugInfoOption(QStringList() << "debug-info", QObject::tr("Displays debugging information."));
+    QCommandLineOption traceOption(
+        "trace", QObject::tr("write timing information to the given Chrome trace file on exit"), QObject::tr("file"));
     parser.addOption(configOption);
     parser.addOption(localConfigOption);
     parser.addOption(lockOption);
     parser.addOption(keyfileOption);
     parser.addOption(pwstdinOption);
     parser.addOption(debugInfoOption);
+    parser.addOption(traceOption);
 
     if (osUtils->canPreventScreenCapture()) {
         parser.addOption(allowScreenCaptureOption);
@@ -149,6 +153,10 @@ int main(int argc, char** argv)
 
     Application::bootstrap();
 
+    if (parser.isSet(traceOption)) {
+        Tracing::start(parser.value(traceOption));
+    }
+
     MainWindow mainWindow;
 
 #ifndef QT_DEBUG
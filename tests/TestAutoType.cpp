@@ -20,9 +20,12 @@
 #include "TestGlobal.h"
 
 #include <QPluginLoader>
+#include <QSignalSpy>
 
 #include "autotype/AutoType.h"
+#include "autotype/AutoTypeMatchModel.h"
 #include "autotype/AutoTypePlatformPlugin.h"
+#include "autotype/AutoTypeSelectDialog.h"
 #include "autotype/test/AutoTypeTestInterface.h"
 #include "core/Config.h"
 #include "core/Resources.h"
@@ -444,3 +447,76 @@ void TestAutoType::testAutoTypeEffectiveSequences()
     QCOMPARE(entry6->defaultAutoTypeSequence(), sequenceOrphan);
     QCOMPARE(entry6->effectiveAutoTypeSequence(), QString());
 }
+
+void TestAutoType::testMatchModelUpdate()
+{
+    AutoTypeMatchModel model;
+    model.setMatchList({{m_entry1, "a"}, {m_entry2, "b"}, {m_entry3, "c"}, {m_entry4, "d"}});
+    QCOMPARE(model.rowCount(), 4);
+
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+    // Narrowing removes the vanished rows in contiguous ranges
+    QVERIFY(model.updateMatchList({{m_entry1, "a"}, {m_entry4, "d"}}));
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.first().at(1).toInt(), 1);
+    QCOMPARE(removedSpy.first().at(2).toInt(), 2);
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.matchFromIndex(model.index(0, 0)), AutoTypeMatch(m_entry1, "a"));
+    QCOMPARE(model.matchFromIndex(model.index(1, 0)), AutoTypeMatch(m_entry4, "d"));
+
+    // An identical list leaves the model alone
+    QVERIFY(!model.updateMatchList({{m_entry1, "a"}, {m_entry4, "d"}}));
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(insertedSpy.count(), 0);
+
+    // New matches are appended, a different sequence of a kept entry is a new match
+    QVERIFY(model.updateMatchList({{m_entry4, "d"}, {m_entry2, "b"}, {m_entry4, "e"}}));
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.last().at(1).toInt(), 1);
+    QCOMPARE(insertedSpy.last().at(2).toInt(), 2);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.matchFromIndex(model.index(0, 0)), AutoTypeMatch(m_entry4, "d"));
+
+    // Updated rows still follow entry removal
+    delete m_entry2;
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(resetSpy.count(), 0);
+
+    // A database that goes away is forgotten, so resetting the model does not touch it
+    auto* otherDb = new Database();
+    auto* otherEntry = new Entry();
+    otherEntry->setGroup(otherDb->rootGroup());
+    QVERIFY(model.updateMatchList({{m_entry4, "d"}, {otherEntry, "f"}}));
+    QCOMPARE(model.rowCount(), 2);
+    delete otherDb;
+    model.setMatchList({{m_entry1, "a"}});
+    QCOMPARE(model.rowCount(), 1);
+}
+
+void TestAutoType::testCanNarrowSearch()
+{
+    // Appending plain text only narrows the results
+    QVERIFY(AutoTypeSelectDialog::canNarrowSearch("", "git"));
+    QVERIFY(AutoTypeSelectDialog::canNarrowSearch("git", "github"));
+    QVERIFY(AutoTypeSelectDialog::canNarrowSearch("git", "git hub"));
+    QVERIFY(AutoTypeSelectDialog::canNarrowSearch("git", "git"));
+
+    // Changed or shortened queries need a full search
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("github", "git"));
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("git", "lab"));
+
+    // Modifiers, wildcards, quotes and field prefixes can widen the results
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("git", "git -hub"));
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("git", "git !hub"));
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("git", "git*"));
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("git", "git|lab"));
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("git", "git \"hub"));
+    QVERIFY(!AutoTypeSelectDialog::canNarrowSearch("", "user:git"));
+}
@@ -51,6 +51,8 @@ private slots:
     void testAutoTypeResults_data();
     void testAutoTypeSyntaxChecks();
     void testAutoTypeEffectiveSequences();
+    void testMatchModelUpdate();
+    void testCanNarrowSearch();
 
 private:
     AutoTypePlatformInterface* m_platform;
@@ -24,6 +24,7 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
+#include "core/Tracing.h"
 #include "crypto/Crypto.h"
 #include "keys/FileKey.h"
 #include "keys/drivers/YubiKey.h"
@@ -31,6 +32,8 @@
 #include "cli/Add.h"
 #include "cli/AddGroup.h"
 #include "cli/Analyze.h"
+#include "cli/AttachmentExport.h"
+#include "cli/AttachmentImport.h"
 #include "cli/Clip.h"
 #include "cli/Create.h"
 #include "cli/Diceware.h"
@@ -52,6 +55,9 @@
 #include "cli/Utils.h"
 
 #include <QClipboard>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QSignalSpy>
 #include <QtConcurrent>
 
@@ -215,6 +221,8 @@ void TestCli::testBatchCommands()
     Commands::setupCommands(false);
     QVERIFY(Commands::getCommand("add"));
     QVERIFY(Commands::getCommand("analyze"));
+    QVERIFY(Commands::getCommand("attachment-export"));
+    QVERIFY(Commands::getCommand("attachment-import"));
     QVERIFY(Commands::getCommand("clip"));
     QVERIFY(Commands::getCommand("close"));
     QVERIFY(Commands::getCommand("db-create"));
@@ -236,7 +244,7 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("rmdir"));
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 22);
+    QCOMPARE(Commands::getCommands().size(), 24);
 }
 
 void TestCli::testInteractiveCommands()
@@ -244,6 +252,8 @@ void TestCli::testInteractiveCommands()
     Commands::setupCommands(true);
     QVERIFY(Commands::getCommand("add"));
     QVERIFY(Commands::getCommand("analyze"));
+    QVERIFY(Commands::getCommand("attachment-export"));
+    QVERIFY(Commands::getCommand("attachment-import"));
     QVERIFY(Commands::getCommand("clip"));
     QVERIFY(Commands::getCommand("close"));
     QVERIFY(Commands::getCommand("db-create"));
@@ -265,7 +275,7 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("rmdir"));
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 22);
+    QCOMPARE(Commands::getCommands().size(), 24);
 }
 
 void TestCli::testAdd()
@@ -435,6 +445,88 @@ void TestCli::testAnalyze()
     QCOMPARE(m_stderr->readAll(), QByteArray());
 }
 
+void TestCli::testAttachments()
+{
+    AttachmentImport importCmd;
+    QVERIFY(!importCmd.name.isEmpty());
+    QVERIFY(importCmd.getDescriptionLine().contains(importCmd.name));
+    AttachmentExport exportCmd;
+    QVERIFY(!exportCmd.name.isEmpty());
+    QVERIFY(exportCmd.getDescriptionLine().contains(exportCmd.name));
+    // The longest command names stay apart from their descriptions
+    QVERIFY(exportCmd.getDescriptionLine().startsWith(exportCmd.name + "   "));
+
+    // Larger than one chunk, so it is copied in several steps
+    QByteArray content;
+    for (int i = 0; content.size() < 3 * 1024 * 1024; ++i) {
+        content.append(QByteArray::number(i)).append('\n');
+    }
+    TemporaryFile importFile;
+    QVERIFY(importFile.open());
+    QCOMPARE(importFile.write(content), qint64(content.size()));
+    importFile.close();
+
+    setInput("a");
+    execCmd(importCmd, {"attachment-import", m_dbFile->fileName(), "/Sample Entry", "data.txt", importFile.fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QCOMPARE(m_stdout->readAll(),
+             QString("Successfully imported attachment %1 as data.txt to entry /Sample Entry.\n")
+                 .arg(importFile.fileName())
+                 .toUtf8());
+
+    auto db = readDatabase();
+    QVERIFY(db);
+    auto* entry = db->rootGroup()->findEntryByPath("/Sample Entry");
+    QVERIFY(entry);
+    QCOMPARE(entry->attachments()->value("data.txt"), content);
+
+    // Existing attachments are only replaced on request
+    setInput("a");
+    execCmd(importCmd, {"attachment-import", m_dbFile->fileName(), "/Sample Entry", "data.txt", importFile.fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray("Attachment data.txt already exists for entry /Sample Entry.\n"));
+
+    setInput("a");
+    execCmd(importCmd,
+            {"attachment-import", "-f", m_dbFile->fileName(), "/Sample Entry", "data.txt", importFile.fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    TemporaryFile exportFile;
+    QVERIFY(exportFile.open());
+    exportFile.close();
+    setInput("a");
+    execCmd(exportCmd, {"attachment-export", m_dbFile->fileName(), "/Sample Entry", "data.txt", exportFile.fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QVERIFY(exportFile.open());
+    QCOMPARE(exportFile.readAll(), content);
+    exportFile.close();
+
+    setInput("a");
+    execCmd(exportCmd, {"attachment-export", "--stdout", m_dbFile->fileName(), "/Sample Entry", "data.txt"});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QCOMPARE(m_stdout->readAll(), content);
+
+    setInput("a");
+    execCmd(exportCmd, {"attachment-export", m_dbFile->fileName(), "/Sample Entry", "data.txt"});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(),
+             QByteArray("No export file specified, use --stdout to write the attachment to stdout.\n"));
+
+    setInput("a");
+    execCmd(exportCmd, {"attachment-export", m_dbFile->fileName(), "/Sample Entry", "missing", exportFile.fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray("Could not find attachment with name missing.\n"));
+
+    setInput("a");
+    execCmd(exportCmd, {"attachment-export", m_dbFile->fileName(), "/Missing", "data.txt", exportFile.fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray("Could not find entry with path /Missing.\n"));
+}
+
 void TestCli::testClip()
 {
     QClipboard* clipboard = QGuiApplication::clipboard();
@@ -671,6 +763,11 @@ void TestCli::testInfo()
     QCOMPARE(m_stdout->readLine(), QByteArray("Cipher: AES 256-bit\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("KDF: AES (6000 rounds)\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("Recycle bin is enabled.\n"));
+    QVERIFY(m_stdout->readLine().startsWith("Number of groups: "));
+    QVERIFY(m_stdout->readLine().startsWith("Number of entries: "));
+    QVERIFY(m_stdout->readLine().startsWith("Number of expired entries: "));
+    QVERIFY(m_stdout->readLine().startsWith("Size of entries: "));
+    QVERIFY(m_stdout->readLine().startsWith("Size of history: "));
 
     // Test with quiet option.
     setInput("a");
@@ -682,6 +779,13 @@ void TestCli::testInfo()
     QCOMPARE(m_stdout->readLine(), QByteArray("Cipher: AES 256-bit\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("KDF: AES (6000 rounds)\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("Recycle bin is enabled.\n"));
+
+    // Test with memory option.
+    setInput("a");
+    execCmd(infoCmd, {"db-info", "-m", m_dbFile->fileName()});
+    m_stderr->readLine(); // Skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QVERIFY(m_stdout->readAll().contains("Memory usage (approximate):\n  Entries: "));
 }
 
 void TestCli::testDiceware()
@@ -1812,6 +1916,60 @@ void TestCli::testInvalidDbFiles()
  * 1c e3 0f d7 8d 20 dc fa 40 b5 0c 18 77 9a fb 0f 02 28 8d b7
  * This secret can be on either slot but must be passive.
  */
+void TestCli::testTraceOption()
+{
+    // The global option is removed before the sub-command parses the arguments
+    QCOMPARE(Utils::removeOptionWithValue({"keepassxc-cli", "--trace", "out.json", "ls", "db.kdbx"}, "trace"),
+             QStringList({"keepassxc-cli", "ls", "db.kdbx"}));
+    QCOMPARE(Utils::removeOptionWithValue({"keepassxc-cli", "--trace=out.json", "ls"}, "trace"),
+             QStringList({"keepassxc-cli", "ls"}));
+    QCOMPARE(Utils::removeOptionWithValue({"keepassxc-cli", "ls", "--trace"}, "trace"),
+             QStringList({"keepassxc-cli", "ls"}));
+    QCOMPARE(Utils::removeOptionWithValue({"keepassxc-cli", "ls", "--tracer", "x"}, "trace"),
+             QStringList({"keepassxc-cli", "ls", "--tracer", "x"}));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath("trace.json");
+
+    {
+        Tracing::Span span("disabled");
+        QVERIFY(!span.isActive());
+    }
+    QVERIFY(!Tracing::stop());
+
+    QVERIFY(Tracing::start(fileName));
+    QVERIFY(Tracing::isEnabled());
+    {
+        Tracing::Span outer("outer", "test");
+        Tracing::Span inner("inner", "test");
+        QVERIFY(inner.isActive());
+        inner.setArg("count", 3);
+    }
+    QVERIFY(Tracing::stop());
+    QVERIFY(!Tracing::isEnabled());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const auto events = QJsonDocument::fromJson(file.readAll()).object().value("traceEvents").toArray();
+
+    QStringList names;
+    for (const auto& value : events) {
+        const auto event = value.toObject();
+        if (event.value("ph").toString() != "X") {
+            continue;
+        }
+        names << event.value("name").toString();
+        QCOMPARE(event.value("cat").toString(), QString("test"));
+        QVERIFY(event.value("dur").toDouble() >= 0);
+        if (event.value("name").toString() == "inner") {
+            QCOMPARE(event.value("args").toObject().value("count").toInt(), 3);
+        }
+    }
+    // Spans are recorded when they end, so the inner one comes first
+    QCOMPARE(names, QStringList({"inner", "outer"}));
+}
+
 void TestCli::testYubiKeyOption()
 {
     if (!YubiKey::instance()->isInitialized()) {
@@ -1831,7 +1989,7 @@ void TestCli::testYubiKeyOption()
 
     bool wouldBlock = false;
     QByteArray challenge("CLITest");
-    Botan::secure_vector<char> response;
+    SecureVector<char> response;
     QByteArray expected("\xA2\x3B\x94\x00\xBE\x47\x9A\x30\xA9\xEB\x50\x9B\x85\x56\x5B\x6B\x30\x25\xB4\x8E", 20);
 
     // Find a key that as configured for this test
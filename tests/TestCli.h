@@ -51,6 +51,7 @@ private slots:
     void testAdd();
     void testAddGroup();
     void testAnalyze();
+    void testAttachments();
     void testClip();
     void testCommandParsing_data();
     void testCommandParsing();
@@ -79,6 +80,7 @@ private slots:
     void testRemoveQuiet();
     void testShow();
     void testInvalidDbFiles();
+    void testTraceOption();
     void testYubiKeyOption();
 
 private:
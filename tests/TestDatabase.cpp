@@ -19,14 +19,24 @@
 #include "TestDatabase.h"
 #include "TestGlobal.h"
 
+#include <QBuffer>
 #include <QSignalSpy>
 
 #include "config-keepassx-tests.h"
+#include "core/Clock.h"
+#include "core/DatabaseJournal.h"
+#include "core/DatabaseStatistics.h"
+#include "core/ExpiryScheduler.h"
+#include "core/Group.h"
 #include "core/Metadata.h"
+#include "core/TagIndex.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 #include "format/KeePass2Writer.h"
+#include "gui/entry/EntryModel.h"
+#include "gui/group/GroupModel.h"
 #include "keys/PasswordKey.h"
+#include "util/DatabaseGenerator.h"
 #include "util/TemporaryFile.h"
 
 QTEST_GUILESS_MAIN(TestDatabase)
@@ -96,6 +106,358 @@ void TestDatabase::testSave()
     QVERIFY(!QFile::exists(backupFilePath));
 }
 
+void TestDatabase::testJournal()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+    const QString journalPath = DatabaseJournal::journalPath(tempFile.fileName());
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    auto db = QSharedPointer<Database>::create();
+    QVERIFY2(db->open(tempFile.fileName(), key, &error), error.toLatin1());
+
+    auto* entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("journaled");
+    entry->setGroup(db->rootGroup());
+    QVERIFY2(db->appendToJournal(&error), error.toLatin1());
+    QVERIFY(QFile::exists(journalPath));
+    QVERIFY(db->journalSize() > 0);
+
+    // Journaled changes are merged back on open
+    auto reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), key, &error), error.toLatin1());
+    auto* replayed = reopened->rootGroup()->findEntryByUuid(entry->uuid());
+    QVERIFY(replayed);
+    QCOMPARE(replayed->title(), QString("journaled"));
+    QVERIFY(reopened->isModified());
+
+    // A full save folds the journal into the database file
+    QVERIFY2(reopened->save(&error), error.toLatin1());
+    QVERIFY(!QFile::exists(journalPath));
+
+    // Metadata changes are not journaled
+    db->metadata()->setName("not journaled");
+    QVERIFY(!db->appendToJournal());
+
+    // Changes are journaled even if they keep the old modification time
+    replayed->setUpdateTimeinfo(false);
+    replayed->setTitle("untimed");
+    QVERIFY2(reopened->appendToJournal(&error), error.toLatin1());
+    auto untimed = QSharedPointer<Database>::create();
+    QVERIFY2(untimed->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QCOMPARE(untimed->rootGroup()->findEntryByUuid(entry->uuid())->title(), QString("untimed"));
+
+    // Discarded changes are not replayed
+    reopened->discardJournal();
+    QVERIFY(!QFile::exists(journalPath));
+    auto discarded = QSharedPointer<Database>::create();
+    QVERIFY2(discarded->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QCOMPARE(discarded->rootGroup()->findEntryByUuid(entry->uuid())->title(), QString("journaled"));
+    QVERIFY(!discarded->isModified());
+
+    // Deleting an item that already has a deletion record is journaled again
+    delete discarded->rootGroup()->findEntryByUuid(entry->uuid());
+    QVERIFY2(discarded->appendToJournal(&error), error.toLatin1());
+    auto* restored = new Entry();
+    restored->setUuid(entry->uuid());
+    restored->setGroup(discarded->rootGroup());
+    QVERIFY2(discarded->appendToJournal(&error), error.toLatin1());
+    delete restored;
+    QVERIFY2(discarded->appendToJournal(&error), error.toLatin1());
+    auto redeleted = QSharedPointer<Database>::create();
+    QVERIFY2(redeleted->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QVERIFY(!redeleted->rootGroup()->findEntryByUuid(entry->uuid()));
+
+    // Changes that cannot be attributed require a full save
+    discarded->markAsModified();
+    QVERIFY(!discarded->appendToJournal());
+}
+
+void TestDatabase::testStatistics()
+{
+    Database db;
+    auto* stats = db.statistics();
+    auto* group = new Group();
+    group->setParent(db.rootGroup());
+
+    auto* entry1 = new Entry();
+    entry1->setPassword("short");
+    entry1->setGroup(group);
+    auto* entry2 = new Entry();
+    entry2->setPassword("short");
+    entry2->setGroup(db.rootGroup());
+    auto* entry3 = new Entry();
+    entry3->setPassword("a much longer password");
+    entry3->setGroup(group);
+
+    QCOMPARE(stats->groupCount(), 2);
+    QCOMPARE(stats->entryCount(), 3);
+    QCOMPARE(stats->uniquePasswords(), 2);
+    QCOMPARE(stats->reusedPasswords(), 1);
+    QCOMPARE(stats->maxPasswordReuse(), 2);
+    QCOMPARE(stats->shortPasswords(), 2);
+    QCOMPARE(stats->expiredEntries(), 0);
+    QCOMPARE(stats->entriesSize(), qint64(entry1->size() + entry2->size() + entry3->size()));
+
+    // Password ratings can be computed from a snapshot and are not repeated
+    auto unrated = stats->unratedPasswords();
+    std::sort(unrated.begin(), unrated.end());
+    QCOMPARE(unrated, QStringList({"a much longer password", "short"}));
+    stats->addPasswordRatings(DatabaseStatistics::ratePasswords(unrated));
+    QVERIFY(stats->unratedPasswords().isEmpty());
+    QVERIFY(stats->weakPasswords() >= 2);
+
+    // Modifications are counted without a rebuild
+    entry2->setPassword("another much longer password");
+    QCOMPARE(stats->uniquePasswords(), 3);
+    QCOMPARE(stats->reusedPasswords(), 0);
+    QCOMPARE(stats->shortPasswords(), 1);
+    QCOMPARE(stats->entriesSize(), qint64(entry1->size() + entry2->size() + entry3->size()));
+    QVERIFY(stats->unratedPasswords().contains("another much longer password"));
+
+    entry3->setExpires(true);
+    entry3->setExpiryTime(Clock::currentDateTimeUtc().addDays(-1));
+    QCOMPARE(stats->expiredEntries(), 1);
+
+    // Recycled groups and entries are not counted, the recycle bin itself is
+    db.recycleGroup(group);
+    QCOMPARE(stats->groupCount(), 2);
+    QCOMPARE(stats->entryCount(), 1);
+    QCOMPARE(stats->expiredEntries(), 0);
+
+    delete entry2;
+    QCOMPARE(stats->entryCount(), 0);
+    QCOMPARE(stats->entriesSize(), qint64(0));
+}
+
+void TestDatabase::testMemoryUsage()
+{
+    Database db;
+    auto usage = db.statistics()->memoryUsage();
+    QCOMPARE(usage.entries, qint64(0));
+    QCOMPARE(usage.history, qint64(0));
+    QCOMPARE(usage.attachments, qint64(0));
+    QVERIFY(usage.groups > 0);
+
+    auto* entry = new Entry();
+    entry->setGroup(db.rootGroup());
+    entry->setNotes(QString(1000, 'x'));
+    entry->attachments()->set("a.bin", QByteArray(4096, 'a'));
+    entry->attachments()->set("b.bin", QByteArray(4096, 'b'));
+    entry->attachments()->set("c.bin", entry->attachments()->value("a.bin"));
+
+    usage = db.statistics()->memoryUsage();
+    QVERIFY(usage.entries > 2000);
+    // Shared attachment data is counted once
+    QVERIFY(usage.attachments >= 8192);
+    QVERIFY(usage.attachments < 12288);
+
+    // History items share unchanged data with the entry
+    entry->beginUpdate();
+    entry->setTitle("title");
+    entry->endUpdate();
+    QCOMPARE(entry->historyItems().size(), 1);
+    const auto withHistory = db.statistics()->memoryUsage();
+    QVERIFY(withHistory.history > 0);
+    QVERIFY(withHistory.history < usage.entries);
+    QCOMPARE(withHistory.attachments, usage.attachments);
+
+    db.addDeletedObject(QUuid::createUuid());
+    QVERIFY(db.statistics()->memoryUsage().deletedObjects > 0);
+    QCOMPARE(withHistory.total(),
+             withHistory.entries + withHistory.history + withHistory.attachments + withHistory.icons
+                 + withHistory.customData + withHistory.groups + withHistory.deletedObjects);
+}
+
+void TestDatabase::testGenerator()
+{
+    DatabaseGenerator::Options options;
+    options.seed = 42;
+    options.groups = 20;
+    options.entries = 200;
+    options.depth = 2;
+    options.historyItems = 2;
+    options.attachmentPercent = 10;
+    options.customIcons = 5;
+    options.referencePercent = 10;
+    options.totpPercent = 10;
+    options.sshKeyPercent = 5;
+
+    auto db1 = DatabaseGenerator(options).generate();
+    auto db2 = DatabaseGenerator(options).generate();
+
+    const auto entries1 = db1->rootGroup()->entriesRecursive();
+    const auto entries2 = db2->rootGroup()->entriesRecursive();
+    QCOMPARE(entries1.size(), 200);
+    QCOMPARE(db1->rootGroup()->groupsRecursive(false).size(), 20);
+    QCOMPARE(db1->metadata()->customIconsOrder().size(), 5);
+
+    // The same seed produces the same content
+    for (int i = 0; i < entries1.size(); ++i) {
+        QCOMPARE(entries1[i]->uuid(), entries2[i]->uuid());
+        QCOMPARE(entries1[i]->password(), entries2[i]->password());
+        QCOMPARE(entries1[i]->timeInfo(), entries2[i]->timeInfo());
+        QCOMPARE(entries1[i]->historyItems().size(), 2);
+    }
+
+    for (const auto* group : db1->rootGroup()->groupsRecursive(false)) {
+        QVERIFY(group->parentGroup() == db1->rootGroup() || group->parentGroup()->parentGroup() == db1->rootGroup());
+    }
+
+    int references = 0;
+    int totps = 0;
+    for (const auto* entry : entries1) {
+        references += entry->attributes()->isReference(EntryAttributes::PasswordKey) ? 1 : 0;
+        totps += entry->hasTotp() ? 1 : 0;
+        QVERIFY(entry->historyItems().last()->timeInfo().lastModificationTime()
+                < entry->timeInfo().lastModificationTime());
+    }
+    QVERIFY(references > 0);
+    QVERIFY(totps > 0);
+
+    options.seed = 43;
+    auto db3 = DatabaseGenerator(options).generate();
+    QVERIFY(db3->rootGroup()->entriesRecursive().first()->uuid() != entries1.first()->uuid());
+}
+
+void TestDatabase::testFindEntryByUuid()
+{
+    Database db;
+    auto* group = new Group();
+    group->setParent(db.rootGroup());
+    auto* entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setGroup(group);
+
+    QCOMPARE(db.findEntryByUuid(entry->uuid()), entry);
+    QCOMPARE(db.rootGroup()->findEntryByUuid(entry->uuid(), true), entry);
+    QCOMPARE(group->findEntryByUuid(entry->uuid(), true), entry);
+    QVERIFY(!db.findEntryByUuid(QUuid::createUuid()));
+
+    // Lookups from a group only find entries below it
+    auto* sibling = new Group();
+    sibling->setParent(db.rootGroup());
+    const QString uuidTerm = entry->uuid().toRfc4122().toHex();
+    QVERIFY(!sibling->findEntryByUuid(entry->uuid(), true));
+    QVERIFY(!sibling->findEntryBySearchTerm(uuidTerm, EntryReferenceType::QUuid));
+    QCOMPARE(group->findEntryBySearchTerm(uuidTerm, EntryReferenceType::QUuid), entry);
+
+    // Changing the uuid after adding the entry is handled
+    entry->setUuid(QUuid::createUuid());
+    QCOMPARE(db.findEntryByUuid(entry->uuid()), entry);
+
+    const QUuid uuid = entry->uuid();
+    delete entry;
+    QVERIFY(!db.findEntryByUuid(uuid));
+
+    // Entries moved to another database are not found anymore
+    entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setGroup(group);
+    Database other;
+    group->setParent(other.rootGroup());
+    QVERIFY(!db.findEntryByUuid(entry->uuid()));
+    QCOMPARE(other.findEntryByUuid(entry->uuid()), entry);
+}
+
+void TestDatabase::testTagIndex()
+{
+    Database db;
+    const auto* index = db.tagIndex();
+
+    auto* entry1 = new Entry();
+    entry1->setTags("Work; Finance");
+    entry1->setGroup(db.rootGroup());
+
+    auto* entry2 = new Entry();
+    entry2->setTags("work,home,,");
+    entry2->setGroup(db.rootGroup());
+
+    // Tags are compared case insensitively and reported with their first spelling
+    QCOMPARE(index->tags(), QStringList({"Finance", "home", "Work"}));
+    QCOMPARE(index->count("WORK"), 2);
+    QCOMPARE(index->entries("work"), QSet<Entry*>({entry1, entry2}));
+    QCOMPARE(index->completions("f"), QStringList({"Finance"}));
+    QCOMPARE(index->completions("", 2), QStringList({"Finance", "home"}));
+    QCOMPARE(index->tagCounts().value("Work"), 2);
+    QCOMPARE(index->tagCounts().value("home"), 1);
+
+    entry2->setTags("home");
+    QCOMPARE(index->entries("work"), QSet<Entry*>({entry1}));
+
+    // Entries copied over, as the merge does, are reindexed as well
+    Entry source;
+    source.setTags("Travel");
+    entry1->copyDataFrom(&source);
+    QCOMPARE(index->tags(), QStringList({"home", "Travel"}));
+
+    delete entry2;
+    QCOMPARE(index->tags(), QStringList({"Travel"}));
+
+    Database other;
+    entry1->setGroup(other.rootGroup());
+    QVERIFY(index->tags().isEmpty());
+    QCOMPARE(other.tagIndex()->tags(), QStringList({"Travel"}));
+
+    QCOMPARE(TagIndex::splitTags(" a ;b,,a; "), QStringList({"a", "b"}));
+}
+
+void TestDatabase::testExpiryScheduler()
+{
+    Database db;
+    const auto* scheduler = db.expiryScheduler();
+    QSignalSpy spyExpired(&db, SIGNAL(entryExpired(Entry*)));
+    const QDateTime now = Clock::currentDateTimeUtc();
+
+    auto* soon = new Entry();
+    soon->setExpires(true);
+    soon->setExpiryTime(now.addMSecs(200));
+    soon->setGroup(db.rootGroup());
+
+    auto* later = new Entry();
+    later->setExpires(true);
+    later->setExpiryTime(now.addDays(1));
+    later->setGroup(db.rootGroup());
+
+    auto* removed = new Entry();
+    removed->setExpires(true);
+    removed->setExpiryTime(now.addMSecs(100));
+    removed->setGroup(db.rootGroup());
+
+    // Entries that expired already are not reported
+    auto* expired = new Entry();
+    expired->setExpires(true);
+    expired->setExpiryTime(now.addDays(-1));
+    expired->setGroup(db.rootGroup());
+
+    QCOMPARE(scheduler->scheduledCount(), 3);
+    QCOMPARE(scheduler->nextExpiry(), now.addMSecs(100));
+    delete removed;
+    QCOMPARE(scheduler->nextExpiry(), now.addMSecs(200));
+
+    QTRY_COMPARE(spyExpired.count(), 1);
+    QCOMPARE(spyExpired.takeFirst().first().value<Entry*>(), soon);
+    QVERIFY(soon->isExpired());
+    QCOMPARE(scheduler->nextExpiry(), now.addDays(1));
+
+    // Changed expiry times are rescheduled
+    later->setExpiryTime(Clock::currentDateTimeUtc().addMSecs(100));
+    QTRY_COMPARE(spyExpired.count(), 1);
+    QCOMPARE(spyExpired.takeFirst().first().value<Entry*>(), later);
+    QCOMPARE(scheduler->scheduledCount(), 0);
+    QVERIFY(!scheduler->nextExpiry().isValid());
+
+    expired->setExpiryTime(Clock::currentDateTimeUtc().addDays(1));
+    QCOMPARE(scheduler->scheduledCount(), 1);
+    expired->setExpires(false);
+    QCOMPARE(scheduler->scheduledCount(), 0);
+    QVERIFY(spyExpired.isEmpty());
+}
+
 void TestDatabase::testSignals()
 {
     TemporaryFile tempFile;
@@ -210,3 +572,211 @@ void TestDatabase::testEmptyRecycleBinWithHierarchicalData()
     writer.writeDatabase(&afterCleanup, db.data());
     QVERIFY(afterCleanup.size() < initialSize);
 }
+
+void TestDatabase::testEmptyRecycleBinBulk()
+{
+    DatabaseGenerator::Options options;
+    options.entries = 500;
+    options.groups = 30;
+    options.historyItems = 1;
+    auto db = DatabaseGenerator(options).generate();
+    db->metadata()->setRecycleBinEnabled(true);
+
+    const auto rootEntries = db->rootGroup()->entries();
+    for (auto* entry : rootEntries) {
+        db->recycleEntry(entry);
+    }
+    const auto rootChildren = db->rootGroup()->children();
+    for (auto* group : rootChildren) {
+        db->recycleGroup(group);
+    }
+    auto* recycleBin = db->metadata()->recycleBin();
+    QVERIFY(recycleBin);
+
+    // Keep one entry outside of the recycle bin
+    auto* kept = new Entry();
+    kept->setUuid(QUuid::createUuid());
+    kept->setGroup(db->rootGroup());
+
+    QSet<QUuid> recycled;
+    for (const auto* entry : recycleBin->entriesRecursive()) {
+        recycled.insert(entry->uuid());
+    }
+    for (const auto* group : recycleBin->groupsRecursive(false)) {
+        recycled.insert(group->uuid());
+    }
+    QCOMPARE(recycled.size(), options.entries + options.groups);
+    const int deletedBefore = db->deletedObjects().size();
+
+    EntryModel entryModel;
+    entryModel.setGroup(recycleBin);
+    QCOMPARE(entryModel.rowCount(), rootEntries.size());
+    GroupModel groupModel(db.data());
+    const QModelIndex binIndex = groupModel.index(recycleBin);
+    QCOMPARE(groupModel.rowCount(binIndex), rootChildren.size());
+
+    QPointer<Entry> recycledEntry = rootEntries.first();
+    QSignalSpy spyEntryRemoved(recycleBin, SIGNAL(entryAboutToRemove(Entry*)));
+    QSignalSpy spyGroupRemoved(db.data(), SIGNAL(groupAboutToRemove(Group*)));
+    QSignalSpy spyRowsRemoved(&groupModel, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+    QSignalSpy spyModified(db.data(), SIGNAL(modified()));
+
+    db->emptyRecycleBin();
+
+    QVERIFY(recycleBin->entries().isEmpty());
+    QVERIFY(recycleBin->children().isEmpty());
+    QCOMPARE(db->rootGroup()->entriesRecursive().size(), 1);
+    QCOMPARE(db->rootGroup()->findEntryByUuid(kept->uuid()), kept);
+    QCOMPARE(entryModel.rowCount(), 0);
+    QCOMPARE(groupModel.rowCount(binIndex), 0);
+    QCOMPARE(db->statistics()->entryCount(), 1);
+
+    // Listeners see the bulk operation instead of one signal per object
+    QCOMPARE(spyEntryRemoved.count(), 0);
+    QCOMPARE(spyGroupRemoved.count(), 0);
+    QCOMPARE(spyRowsRemoved.count(), 1);
+    QTRY_VERIFY(!spyModified.isEmpty());
+
+    // All tombstones are recorded with the same deletion time
+    const auto deletedObjects = db->deletedObjects();
+    QCOMPARE(deletedObjects.size(), deletedBefore + recycled.size());
+    const QDateTime deletionTime = deletedObjects.last().deletionTime;
+    for (int i = deletedBefore; i < deletedObjects.size(); ++i) {
+        QVERIFY(recycled.contains(deletedObjects[i].uuid));
+        QCOMPARE(deletedObjects[i].deletionTime, deletionTime);
+    }
+
+    // The detached objects are freed on this thread once the event loop runs
+    QVERIFY(recycledEntry);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QVERIFY(!recycledEntry);
+    QCOMPARE(db->rootGroup()->entriesRecursive().size(), 1);
+}
+
+namespace
+{
+    QImage testIcon(int size, QRgb background)
+    {
+        // Draw in blocks so a larger copy is the same picture at a higher resolution
+        QImage image(size, size, QImage::Format_ARGB32);
+        const int block = size / 4;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                image.setPixel(x, y, ((x / block + y / block) % 2) ? background : qRgba(0, 0, 0, 0));
+            }
+        }
+        return image;
+    }
+} // namespace
+
+void TestDatabase::testCustomIconDeduplication()
+{
+    Database db;
+    auto* metadata = db.metadata();
+
+    const QImage icon = testIcon(32, qRgb(204, 28, 36));
+    const QUuid uuid = QUuid::createUuid();
+    metadata->addCustomIcon(uuid, icon);
+
+    // Different pixel formats of the same picture are found
+    QCOMPARE(metadata->findCustomIcon(icon), uuid);
+    QCOMPARE(metadata->findCustomIcon(icon.convertToFormat(QImage::Format_ARGB32_Premultiplied)), uuid);
+    QCOMPARE(metadata->findCustomIcon(icon.convertToFormat(QImage::Format_Indexed8)), uuid);
+    QVERIFY(metadata->findCustomIcon(testIcon(32, qRgb(28, 204, 36))).isNull());
+    QVERIFY(metadata->findCustomIcon(icon.scaled(64, 32)).isNull());
+    QVERIFY(metadata->findCustomIcon(QImage()).isNull());
+
+    // Colors one step apart are different icons, each found by itself
+    const QUuid lowUuid = QUuid::createUuid();
+    const QUuid highUuid = QUuid::createUuid();
+    metadata->addCustomIcon(lowUuid, testIcon(32, qRgb(199, 40, 40)));
+    metadata->addCustomIcon(highUuid, testIcon(32, qRgb(200, 40, 40)));
+    QCOMPARE(metadata->findCustomIcon(testIcon(32, qRgb(199, 40, 40))), lowUuid);
+    QCOMPARE(metadata->findCustomIcon(testIcon(32, qRgb(200, 40, 40))), highUuid);
+
+    // Normalizing scales large icons down to the stored size
+    const QImage large = testIcon(512, qRgb(36, 28, 204));
+    const QImage normalized = Metadata::normalizeCustomIcon(large);
+    QCOMPARE(normalized.size(), QSize(Metadata::MaxCustomIconSize, Metadata::MaxCustomIconSize));
+    QCOMPARE(normalized.format(), QImage::Format_ARGB32);
+
+    // A normalized icon is found by the large original it came from
+    const QUuid largeUuid = QUuid::createUuid();
+    metadata->addCustomIcon(largeUuid, normalized);
+    QCOMPARE(metadata->customIcon(largeUuid), normalized);
+    QCOMPARE(metadata->findCustomIcon(large), largeUuid);
+
+    // The stored encoding is computed once and decodes to the stored icon
+    const QByteArray data = metadata->customIconData(largeUuid);
+    QVERIFY(!data.isEmpty());
+    QCOMPARE(QImage::fromData(data).convertToFormat(QImage::Format_ARGB32), metadata->customIcon(largeUuid));
+    QVERIFY(metadata->customIconData(QUuid::createUuid()).isEmpty());
+
+    // Icons added from encoded data are kept as they are and saved back unchanged
+    QByteArray largeData;
+    QBuffer buffer(&largeData);
+    buffer.open(QIODevice::WriteOnly);
+    large.save(&buffer, "BMP");
+    const QUuid loadedUuid = QUuid::createUuid();
+    metadata->addCustomIcon(loadedUuid, largeData);
+    QCOMPARE(metadata->customIcon(loadedUuid).size(), large.size());
+    QCOMPARE(metadata->customIconData(loadedUuid), largeData);
+    QCOMPARE(metadata->findCustomIcon(large), largeUuid);
+
+    // A remaining duplicate takes over the index when the indexed icon is removed
+    const QUuid duplicateUuid = QUuid::createUuid();
+    metadata->addCustomIcon(duplicateUuid, icon.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    QCOMPARE(metadata->findCustomIcon(icon), uuid);
+    metadata->removeCustomIcon(uuid);
+    QCOMPARE(metadata->findCustomIcon(icon), duplicateUuid);
+}
+
+void TestDatabase::testMergeDuplicateCustomIcons()
+{
+    Database db;
+    auto* metadata = db.metadata();
+
+    const QImage icon = testIcon(16, qRgb(12, 124, 252));
+    const QUuid original = QUuid::createUuid();
+    const QUuid copy = QUuid::createUuid();
+    const QUuid otherCopy = QUuid::createUuid();
+    const QUuid distinct = QUuid::createUuid();
+    metadata->addCustomIcon(original, icon);
+    metadata->addCustomIcon(copy, icon.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    metadata->addCustomIcon(otherCopy, icon.convertToFormat(QImage::Format_Indexed8));
+    metadata->addCustomIcon(distinct, testIcon(16, qRgb(252, 124, 12)));
+
+    const auto duplicates = metadata->duplicateCustomIcons();
+    QCOMPARE(duplicates.size(), 2);
+    QCOMPARE(duplicates.value(copy), original);
+    QCOMPARE(duplicates.value(otherCopy), original);
+
+    auto* group = new Group();
+    group->setParent(db.rootGroup());
+    group->setIcon(copy);
+
+    auto* entry = new Entry();
+    entry->setGroup(group);
+    entry->setIcon(otherCopy);
+    entry->beginUpdate();
+    entry->setIcon(copy);
+    entry->endUpdate();
+    QCOMPARE(entry->historyItems().size(), 1);
+
+    auto* distinctEntry = new Entry();
+    distinctEntry->setGroup(db.rootGroup());
+    distinctEntry->setIcon(distinct);
+
+    const auto modified = entry->timeInfo().lastModificationTime();
+    QCOMPARE(db.mergeDuplicateCustomIcons(), 2);
+
+    QCOMPARE(metadata->customIconsOrder(), QList<QUuid>({original, distinct}));
+    QCOMPARE(group->iconUuid(), original);
+    QCOMPARE(entry->iconUuid(), original);
+    QCOMPARE(entry->historyItems().first()->iconUuid(), original);
+    QCOMPARE(distinctEntry->iconUuid(), distinct);
+    QCOMPARE(entry->timeInfo().lastModificationTime(), modified);
+    QCOMPARE(entry->historyItems().size(), 1);
+
+    QCOMPARE(db.mergeDuplicateCustomIcons(), 0);
+}
@@ -29,11 +29,21 @@ private slots:
     void initTestCase();
     void testOpen();
     void testSave();
+    void testJournal();
+    void testStatistics();
+    void testMemoryUsage();
+    void testGenerator();
+    void testFindEntryByUuid();
+    void testTagIndex();
+    void testExpiryScheduler();
     void testSignals();
     void testEmptyRecycleBinOnDisabled();
     void testEmptyRecycleBinOnNotCreated();
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
+    void testEmptyRecycleBinBulk();
+    void testCustomIconDeduplication();
+    void testMergeDuplicateCustomIcons();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
@@ -19,6 +19,7 @@
 #include "TestGlobal.h"
 
 #include "config-keepassx-tests.h"
+#include "core/Clock.h"
 #include "crypto/Crypto.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2.h"
@@ -151,3 +152,59 @@ void TestDeletedObjects::testDatabaseChange()
 
     delete group;
 }
+
+void TestDeletedObjects::testDeletedObjectsIndex()
+{
+    Database db;
+    const QDateTime now = Clock::currentDateTimeUtc();
+    const QUuid uuid1 = QUuid::createUuid();
+    const QUuid uuid2 = QUuid::createUuid();
+
+    db.addDeletedObject({uuid1, now});
+    db.addDeletedObject({uuid2, now});
+    QVERIFY(db.containsDeletedObject(uuid1));
+    QVERIFY(db.containsDeletedObject(uuid2));
+    QVERIFY(!db.containsDeletedObject(QUuid::createUuid()));
+
+    // Each uuid is recorded once with its earliest deletion time
+    db.addDeletedObject({uuid1, now.addDays(1)});
+    QCOMPARE(db.deletedObjects().size(), 2);
+    QCOMPARE(db.deletedObjects().at(0).deletionTime, now);
+    db.addDeletedObject({uuid1, now.addDays(-1)});
+    QCOMPARE(db.deletedObjects().size(), 2);
+    QCOMPARE(db.deletedObjects().at(0).deletionTime, now.addDays(-1));
+
+    db.truncateDeletedObjects(1);
+    QCOMPARE(db.deletedObjects().size(), 1);
+    QVERIFY(db.containsDeletedObject(uuid1));
+    QVERIFY(!db.containsDeletedObject(uuid2));
+
+    db.setDeletedObjects({{uuid2, now}});
+    QVERIFY(!db.containsDeletedObject(uuid1));
+    QVERIFY(db.containsDeletedObject(uuid2));
+}
+
+void TestDeletedObjects::testPruneDeletedObjects()
+{
+    Database db;
+    const QDateTime now = Clock::currentDateTimeUtc();
+    const QUuid recent = QUuid::createUuid();
+    const QUuid old = QUuid::createUuid();
+    db.addDeletedObject({old, now.addDays(-100)});
+    db.addDeletedObject({recent, now.addDays(-10)});
+
+    // Deletion records are kept forever by default
+    QCOMPARE(db.deletedObjectsMaxAge(), 0);
+    QCOMPARE(db.pruneDeletedObjects(), 0);
+    QCOMPARE(db.deletedObjects().size(), 2);
+
+    db.setDeletedObjectsMaxAge(30);
+    QCOMPARE(db.deletedObjectsMaxAge(), 30);
+    QCOMPARE(db.pruneDeletedObjects(), 1);
+    QCOMPARE(db.deletedObjects().size(), 1);
+    QVERIFY(db.containsDeletedObject(recent));
+    QVERIFY(!db.containsDeletedObject(old));
+
+    db.setDeletedObjectsMaxAge(0);
+    QCOMPARE(db.deletedObjectsMaxAge(), 0);
+}
@@ -34,6 +34,8 @@ private slots:
     void testDeletedObjectsFromFile();
     void testDeletedObjectsFromNewDb();
     void testDatabaseChange();
+    void testDeletedObjectsIndex();
+    void testPruneDeletedObjects();
 };
 
 #endif // KEEPASSX_TESTDELETEDOBJECTS_H
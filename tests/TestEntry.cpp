@@ -16,13 +16,16 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QBuffer>
 #include <QScopedPointer>
+#include <QSignalSpy>
 
 #include "TestEntry.h"
 #include "TestGlobal.h"
 #include "core/Clock.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
+#include "crypto/CryptoHash.h"
 
 QTEST_GUILESS_MAIN(TestEntry)
 
@@ -79,6 +82,26 @@ void TestEntry::testCopyDataFrom()
     QCOMPARE(entry2->autoTypeAssociations()->size(), 2);
     QCOMPARE(entry2->autoTypeAssociations()->get(0).window, QString("1"));
     QCOMPARE(entry2->autoTypeAssociations()->get(1).window, QString("3"));
+
+    // Copying signals a change only if the copied data differs
+    QSignalSpy spyModified(entry2.data(), SIGNAL(modified()));
+    entry2->copyDataFrom(entry.data());
+    QCOMPARE(spyModified.count(), 0);
+    entry->setForegroundColor("#FF0000");
+    entry2->copyDataFrom(entry.data());
+    QCOMPARE(spyModified.count(), 1);
+    QCOMPARE(entry2->foregroundColor(), QString("#FF0000"));
+
+    // The data change is signalled once, whether the entry data, the attributes or both differ
+    QSignalSpy spyDataChanged(entry2.data(), SIGNAL(entryDataChanged(Entry*)));
+    entry->setTags("copied");
+    entry2->copyDataFrom(entry.data());
+    QCOMPARE(spyDataChanged.count(), 1);
+    entry->setUsername("copied");
+    entry2->copyDataFrom(entry.data());
+    QCOMPARE(spyDataChanged.count(), 2);
+    entry2->copyDataFrom(entry.data());
+    QCOMPARE(spyDataChanged.count(), 2);
 }
 
 void TestEntry::testClone()
@@ -723,3 +746,104 @@ void TestEntry::testMove()
     QCOMPARE(root->entries().at(2), entry1);
     QCOMPARE(root->entries().at(3), entry0);
 }
+
+void TestEntry::testFoldedFields()
+{
+    Entry entry;
+    entry.setTitle(QString::fromUtf8("\xEF\xBC\xA7it\xEF\xAC\x81le")); // Full width G and fi ligature
+    entry.setUsername("User@Example.COM");
+    entry.setUrl("https://Login.Example.com/path");
+    entry.setTags("Work;Private");
+
+    QCOMPARE(entry.foldedField(Entry::FoldedField::Title), QString("gitfile"));
+    QCOMPARE(entry.foldedField(Entry::FoldedField::Username), QString("user@example.com"));
+    QCOMPARE(entry.foldedField(Entry::FoldedField::Url), QString("https://login.example.com/path"));
+    QCOMPARE(entry.foldedField(Entry::FoldedField::Host), QString("login.example.com"));
+    QCOMPARE(entry.foldedField(Entry::FoldedField::Tags), QString("work;private"));
+
+    // Changes are picked up even when modification signals are blocked
+    entry.setEmitModified(false);
+    entry.setTitle("Other");
+    entry.setUrl("");
+    QCOMPARE(entry.foldedField(Entry::FoldedField::Title), QString("other"));
+    QCOMPARE(entry.foldedField(Entry::FoldedField::Host), QString());
+}
+
+void TestEntry::testAttachmentStreaming()
+{
+    Entry entry;
+    auto* attachments = entry.attachments();
+    const QByteArray content(3 * 1024 * 1024 + 17, 'x');
+
+    QBuffer source;
+    source.setData(content);
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    QList<qint64> steps;
+    QVERIFY(attachments->importAttachment("data", &source, nullptr, [&steps](qint64 done, qint64 total) {
+        steps.append(done);
+        return total == 3 * 1024 * 1024 + 17;
+    }));
+    QCOMPARE(attachments->value("data"), content);
+    QCOMPARE(steps.size(), 4);
+    QCOMPARE(steps.last(), qint64(content.size()));
+
+    // A canceled import leaves the attachments untouched
+    source.seek(0);
+    QString error;
+    QVERIFY(!attachments->importAttachment("other", &source, &error, [](qint64, qint64) { return false; }));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!attachments->hasKey("other"));
+
+    QBuffer target;
+    QVERIFY(target.open(QIODevice::WriteOnly));
+    QVERIFY(attachments->exportAttachment("data", &target));
+    QCOMPARE(target.data(), content);
+    QVERIFY(!attachments->exportAttachment("other", &target, &error));
+}
+
+void TestEntry::testAttachmentDigests()
+{
+    EntryAttachments attachments;
+    const QByteArray small("small attachment");
+    const QByteArray large(1024 * 1024, 'x');
+
+    attachments.set("small", small);
+    attachments.set("large", large);
+    QCOMPARE(attachments.digest("small"), CryptoHash::hash(small, CryptoHash::Sha256));
+    QCOMPARE(attachments.digest("large"), CryptoHash::hash(large, CryptoHash::Sha256));
+    QVERIFY(attachments.digest("missing").isEmpty());
+    QCOMPARE(attachments.digests().size(), 2);
+
+    // Equal content that is not shared still compares equal
+    EntryAttachments other;
+    other.set("small", QByteArray("small attachment"));
+    other.set("large", QByteArray(1024 * 1024, 'x'));
+    QVERIFY(attachments == other);
+
+    QByteArray changed = large;
+    changed[512] = 'y';
+    other.set("large", changed);
+    QVERIFY(attachments != other);
+    QVERIFY(attachments.digest("large") != other.digest("large"));
+
+    // Copies share the digests of the data they share
+    other.copyDataFrom(&attachments);
+    QVERIFY(attachments == other);
+    QCOMPARE(other.digest("large"), attachments.digest("large"));
+
+    other.rename("large", "renamed");
+    QCOMPARE(other.digest("renamed"), attachments.digest("large"));
+    QVERIFY(other.digest("large").isEmpty());
+    QVERIFY(attachments != other);
+
+    other.clear();
+    QVERIFY(other.digests().isEmpty());
+
+    // Setting a buffer that is already attached elsewhere reuses its digest
+    EntryAttachments history;
+    history.set("large", attachments.value("large"));
+    QCOMPARE(history.digest("large").constData(), attachments.digest("large").constData());
+    history.set("copy", QByteArray(1024 * 1024, 'x'));
+    QCOMPARE(history.digest("copy"), attachments.digest("large"));
+    QVERIFY(history.digest("copy").constData() != attachments.digest("large").constData());
+}
@@ -39,6 +39,9 @@ private slots:
     void testResolveClonedEntry();
     void testIsRecycled();
     void testMove();
+    void testFoldedFields();
+    void testAttachmentStreaming();
+    void testAttachmentDigests();
 };
 
 #endif // KEEPASSX_TESTENTRY_H
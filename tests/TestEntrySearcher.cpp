@@ -18,6 +18,8 @@
 #include "TestEntrySearcher.h"
 #include "TestGlobal.h"
 
+#include "core/Database.h"
+
 QTEST_GUILESS_MAIN(TestEntrySearcher)
 
 void TestEntrySearcher::init()
@@ -242,6 +244,105 @@ void TestEntrySearcher::testSearchTermParser()
     QCOMPARE(terms[1].regex.pattern(), QString("ddd"));
 }
 
+void TestEntrySearcher::testTermClassification()
+{
+    using MatchType = EntrySearcher::MatchType;
+
+    m_entrySearcher.parseSearchTerms("github *hub* +git* +*hub +github +*git* g?thub a|b *\\d+ \"a.b\"");
+    auto terms = m_entrySearcher.m_searchTerms;
+
+    QCOMPARE(terms.length(), 10);
+    QCOMPARE(terms[0].type, MatchType::Literal);
+    QCOMPARE(terms[0].text, QString("github"));
+    QCOMPARE(terms[1].type, MatchType::Literal);
+    QCOMPARE(terms[1].text, QString("hub"));
+    QCOMPARE(terms[2].type, MatchType::Prefix);
+    QCOMPARE(terms[2].text, QString("git"));
+    QCOMPARE(terms[3].type, MatchType::Suffix);
+    QCOMPARE(terms[3].text, QString("hub"));
+    QCOMPARE(terms[4].type, MatchType::Exact);
+    QCOMPARE(terms[5].type, MatchType::Literal);
+    QCOMPARE(terms[5].text, QString("git"));
+    QCOMPARE(terms[6].type, MatchType::Regex);
+    QCOMPARE(terms[7].type, MatchType::Regex);
+    QCOMPARE(terms[8].type, MatchType::Regex);
+    QCOMPARE(terms[9].type, MatchType::Literal);
+    QCOMPARE(terms[9].text, QString("a.b"));
+
+    auto* entry = new Entry();
+    entry->setGroup(m_rootGroup);
+    entry->setTitle("GitHub");
+    entry->setUrl("https://github.com/a.b");
+
+    auto* other = new Entry();
+    other->setGroup(m_rootGroup);
+    other->setTitle("axb");
+
+    // Literal terms match like the regex they replace, including case folding
+    QCOMPARE(m_entrySearcher.search("GITHUB", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("a.b", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("+title:git*", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("+title:*hub", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("+title:github", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("+title:git", m_rootGroup), QList<Entry*>());
+    QCOMPARE(m_entrySearcher.search("-github", m_rootGroup), QList<Entry*>({other}));
+    QCOMPARE(m_entrySearcher.search("*", m_rootGroup).size(), 2);
+
+    // Case insensitive literal terms also match compatibility forms
+    other->setUsername(QString::fromUtf8("\xEF\xBC\xA1\xEF\xBC\xA2\xEF\xBC\xA3")); // Full width ABC
+    QCOMPARE(m_entrySearcher.search("user:abc", m_rootGroup), QList<Entry*>({other}));
+
+    m_entrySearcher.setCaseSensitive(true);
+    QCOMPARE(m_entrySearcher.search("github", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("title:github", m_rootGroup), QList<Entry*>());
+    QCOMPARE(m_entrySearcher.search("title:GitHub", m_rootGroup), QList<Entry*>({entry}));
+}
+
+void TestEntrySearcher::testEmbeddedPlaceholders()
+{
+    auto* entry = new Entry();
+    entry->setGroup(m_rootGroup);
+    entry->attributes()->set("host", "Example.org");
+    entry->setUsername("Alice");
+    entry->setTitle("Login {USERNAME}");
+    entry->setUrl("https://{S:host}/x");
+
+    // Placeholders in the middle of a field are resolved before matching
+    QCOMPARE(m_entrySearcher.search("url:example.org/x", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("title:\"login alice\"", m_rootGroup), QList<Entry*>({entry}));
+    QCOMPARE(m_entrySearcher.search("title:username", m_rootGroup), QList<Entry*>());
+}
+
+void TestEntrySearcher::testTagSearch()
+{
+    Database db;
+    auto* entry1 = new Entry();
+    entry1->setGroup(db.rootGroup());
+    entry1->setTitle("first");
+    entry1->setTags("Work;Finance");
+
+    auto* entry2 = new Entry();
+    entry2->setGroup(db.rootGroup());
+    entry2->setTitle("second");
+    entry2->setTags("homework");
+
+    // Tags without wildcards match whole tags only
+    QCOMPARE(m_entrySearcher.search("tag:work", db.rootGroup()), QList<Entry*>({entry1}));
+    QCOMPARE(m_entrySearcher.search("tag:*work", db.rootGroup()), QList<Entry*>({entry1, entry2}));
+    QCOMPARE(m_entrySearcher.search("tags:finance tag:work", db.rootGroup()), QList<Entry*>({entry1}));
+    QCOMPARE(m_entrySearcher.search("-tag:work", db.rootGroup()), QList<Entry*>({entry2}));
+    QCOMPARE(m_entrySearcher.search("tag:work second", db.rootGroup()), QList<Entry*>());
+    QCOMPARE(m_entrySearcher.search("tag:unknown", db.rootGroup()), QList<Entry*>());
+
+    // Changed tags are found through the index right away
+    entry2->setTags("Work");
+    QCOMPARE(m_entrySearcher.search("tag:WORK", db.rootGroup()), QList<Entry*>({entry1, entry2}));
+
+    m_entrySearcher.setCaseSensitive(true);
+    QCOMPARE(m_entrySearcher.search("tag:work", db.rootGroup()), QList<Entry*>());
+    QCOMPARE(m_entrySearcher.search("tag:Work", db.rootGroup()), QList<Entry*>({entry1, entry2}));
+}
+
 void TestEntrySearcher::testCustomAttributesAreSearched()
 {
     QScopedPointer<Entry> e1(new Entry());
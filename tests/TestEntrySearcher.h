@@ -35,6 +35,9 @@ private slots:
     void testSearch();
     void testAllAttributesAreSearched();
     void testSearchTermParser();
+    void testTermClassification();
+    void testEmbeddedPlaceholders();
+    void testTagSearch();
     void testCustomAttributesAreSearched();
     void testGroup();
     void testSkipProtected();
@@ -115,7 +115,9 @@ void TestGroup::testParenting()
     g1->setName("test");
     g3->setIcon(QUuid::createUuid());
     g1->setIcon(2);
-    QCOMPARE(spy.count(), 6);
+    g2->setDefaultAutoTypeSequence("{USERNAME}");
+    g4->setAutoTypeEnabled(Group::Disable);
+    QCOMPARE(spy.count(), 8);
     delete db;
 
     QVERIFY(rootGroup.isNull());
@@ -1209,6 +1211,50 @@ void TestGroup::testUsernamesRecursive()
     QVERIFY(usernames.indexOf("Name2") < usernames.indexOf("Name1"));
 }
 
+void TestGroup::testCommonUsernames()
+{
+    Database database;
+
+    Group* subgroup = new Group();
+    subgroup->setName("Subgroup");
+    subgroup->setParent(database.rootGroup());
+
+    Entry* rootGroupEntry = database.rootGroup()->addEntryWithPath("Root group entry");
+    rootGroupEntry->setUsername("Name1");
+    Entry* subgroupEntry = subgroup->addEntryWithPath("Subgroup entry");
+    subgroupEntry->setUsername("Name2");
+    Entry* subgroupEntryReusingUsername = subgroup->addEntryWithPath("Another subgroup entry");
+    subgroupEntryReusingUsername->setUsername("Name2");
+    Entry* referenceEntry = subgroup->addEntryWithPath("Reference entry");
+    referenceEntry->setUsername(QString("{REF:U@I:%1}").arg(rootGroupEntry->uuidToHex()));
+
+    // Statistics are kept up to date without walking the tree
+    QCOMPARE(database.commonUsernames(), database.rootGroup()->usernamesRecursive(10));
+    QCOMPARE(database.commonUsernames(), QList<QString>({"Name2", "Name1"}));
+    QCOMPARE(database.commonUsernames(1), QList<QString>({"Name2"}));
+
+    subgroupEntry->setUsername("Name1");
+    QCOMPARE(database.commonUsernames(), QList<QString>({"Name1", "Name2"}));
+
+    delete subgroupEntryReusingUsername;
+    QCOMPARE(database.commonUsernames(), QList<QString>({"Name1"}));
+
+    // Entries copied over, as the merge does, are counted with their new username
+    Entry source;
+    source.setUsername("Name3");
+    subgroupEntry->copyDataFrom(&source);
+    QCOMPARE(database.commonUsernames(), QList<QString>({"Name1", "Name3"}));
+
+    // Entries leave the statistics together with their group
+    Database otherDatabase;
+    subgroup->setParent(otherDatabase.rootGroup());
+    QCOMPARE(database.commonUsernames(), QList<QString>({"Name1"}));
+    QCOMPARE(otherDatabase.commonUsernames(), QList<QString>({"Name3"}));
+
+    delete rootGroupEntry;
+    QVERIFY(database.commonUsernames().isEmpty());
+}
+
 void TestGroup::testMove()
 {
     Database database;
@@ -49,6 +49,7 @@ private slots:
     void testHierarchy();
     void testApplyGroupIconRecursively();
     void testUsernamesRecursive();
+    void testCommonUsernames();
     void testMove();
 };
 
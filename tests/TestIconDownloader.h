@@ -28,8 +28,14 @@ class TestIconDownloader : public QObject
     Q_OBJECT
 
 private slots:
+    void initTestCase();
     void testIconDownloader();
     void testIconDownloader_data();
+    void testDownloadWithoutUrls();
+    void testRegistrableDomain();
+    void testSchedulerDeduplicatesDomains();
+    void testSchedulerConcurrency();
+    void testSchedulerCache();
 };
 
 #endif // KEEPASSXC_TESTICONDOWNLOADER_HPP
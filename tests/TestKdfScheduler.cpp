@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestKdfScheduler.h"
+
+#include "crypto/kdf/KdfScheduler.h"
+
+#include <QTest>
+#include <QTimer>
+#include <QtConcurrent>
+
+QTEST_GUILESS_MAIN(TestKdfScheduler)
+
+void TestKdfScheduler::cleanup()
+{
+    auto scheduler = KdfScheduler::instance();
+    scheduler->setMemoryBudget(KdfScheduler::DEFAULT_MEMORY_BUDGET);
+    QCOMPARE(scheduler->activeDerivations(), 0);
+    QCOMPARE(scheduler->queueDepth(), 0);
+}
+
+void TestKdfScheduler::testBudget()
+{
+    auto scheduler = KdfScheduler::instance();
+    scheduler->setMemoryBudget(100);
+
+    QVERIFY(scheduler->acquire(60, KdfScheduler::Priority::Interactive));
+    QCOMPARE(scheduler->memoryInUse(), 60ull);
+
+    auto future = QtConcurrent::run(
+        [scheduler]() { return scheduler->acquire(60, KdfScheduler::Priority::Interactive); });
+    QTRY_COMPARE(scheduler->queueDepth(), 1);
+    QVERIFY(!future.isFinished());
+
+    scheduler->release(60);
+    QVERIFY(future.result());
+    QCOMPARE(scheduler->activeDerivations(), 1);
+    scheduler->release(60);
+    QCOMPARE(scheduler->memoryInUse(), 0ull);
+}
+
+void TestKdfScheduler::testOversizedRequest()
+{
+    auto scheduler = KdfScheduler::instance();
+    scheduler->setMemoryBudget(10);
+
+    // Nothing else is running, so a request larger than the budget must not block
+    {
+        KdfScheduler::Reservation reservation(100);
+        QVERIFY(reservation.isValid());
+        QCOMPARE(scheduler->memoryInUse(), 100ull);
+    }
+    QCOMPARE(scheduler->memoryInUse(), 0ull);
+}
+
+void TestKdfScheduler::testCancelPending()
+{
+    auto scheduler = KdfScheduler::instance();
+    scheduler->setMemoryBudget(100);
+
+    QVERIFY(scheduler->acquire(60, KdfScheduler::Priority::Interactive));
+
+    int owner1 = 0;
+    int owner2 = 0;
+    auto derive = [](const void* owner) {
+        KdfScheduler::PriorityScope priority(KdfScheduler::Priority::Background, owner);
+        KdfScheduler::Reservation reservation(60);
+        return reservation.isValid();
+    };
+    auto future1 = QtConcurrent::run(derive, static_cast<const void*>(&owner1));
+    auto future2 = QtConcurrent::run(derive, static_cast<const void*>(&owner2));
+    QTRY_COMPARE(scheduler->queueDepth(), 2);
+
+    // Only the derivations of the given owner are cancelled
+    scheduler->cancelPending(&owner1);
+    QVERIFY(!future1.result());
+    QCOMPARE(scheduler->queueDepth(), 1);
+    QVERIFY(!future2.isFinished());
+
+    scheduler->cancelPending(nullptr);
+    QCOMPARE(scheduler->queueDepth(), 1);
+
+    scheduler->release(60);
+    QVERIFY(future2.result());
+    QCOMPARE(scheduler->memoryInUse(), 0ull);
+}
+
+void TestKdfScheduler::testWaitOnMainThread()
+{
+    auto scheduler = KdfScheduler::instance();
+    scheduler->setMemoryBudget(100);
+
+    QVERIFY(scheduler->tryAcquire(60, KdfScheduler::Priority::Interactive));
+    QCOMPARE(scheduler->memoryInUse(), 60ull);
+    QVERIFY(!scheduler->tryAcquire(60, KdfScheduler::Priority::Interactive));
+
+    // The event loop keeps running while the reservation waits, so the timer can release the memory
+    QTimer::singleShot(50, [scheduler] { scheduler->release(60); });
+    {
+        KdfScheduler::Reservation reservation(60);
+        QVERIFY(reservation.isValid());
+        QCOMPARE(scheduler->memoryInUse(), 60ull);
+    }
+    QCOMPARE(scheduler->memoryInUse(), 0ull);
+}
@@ -20,6 +20,9 @@
 #include "TestGlobal.h"
 
 #include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextCodec>
 
 #include "config-keepassx-tests.h"
 
@@ -195,6 +198,47 @@ void TestKeys::testFileKeyHash()
     QCOMPARE(fileKey.rawKey(), cryptoHash.result());
 }
 
+void TestKeys::testFileKeyHashLarge()
+{
+    // Spans several read chunks and starts like an XML document without being one
+    QByteArray data = QByteArray("<not a key file>") + QByteArray(3 * 1024 * 1024 + 17, 'x');
+    QBuffer keyBuffer(&data);
+    keyBuffer.open(QBuffer::ReadOnly);
+
+    CryptoHash cryptoHash(CryptoHash::Sha256);
+    cryptoHash.addData(data);
+
+    FileKey fileKey;
+    QVERIFY(fileKey.load(&keyBuffer));
+    QCOMPARE(fileKey.type(), FileKey::Hashed);
+    QCOMPARE(fileKey.rawKey(), cryptoHash.result());
+}
+
+void TestKeys::testFileKeyXmlEncodings()
+{
+    QFile file(QString("%1/FileKeyXmlV2.keyx").arg(QString(KEEPASSX_TEST_DATA_DIR)));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray xml = file.readAll();
+    FileKey expected;
+    QVERIFY(expected.load(file.fileName()));
+
+    // Neither variant shows '<' within the format detection prefix
+    const QString utf16Xml = QString::fromUtf8(xml).replace("encoding=\"utf-8\"", "encoding=\"UTF-16\"");
+    QList<QByteArray> variants;
+    variants << QByteArray("\xFF\xFE") + QTextCodec::codecForName("UTF-16LE")->fromUnicode(utf16Xml);
+    variants << QByteArray(256, ' ') + xml.mid(xml.indexOf("<KeyFile"));
+
+    for (QByteArray& data : variants) {
+        QBuffer keyBuffer(&data);
+        keyBuffer.open(QBuffer::ReadOnly);
+        FileKey fileKey;
+        QString error;
+        QVERIFY2(fileKey.load(&keyBuffer, &error), error.toLatin1());
+        QCOMPARE(fileKey.type(), FileKey::KeePass2XMLv2);
+        QCOMPARE(fileKey.rawKey(), expected.rawKey());
+    }
+}
+
 void TestKeys::testFileKeyError()
 {
     bool result;
@@ -320,3 +364,33 @@ void TestKeys::testCompositeKeyComponents()
     QVERIFY(!reader.readDatabase(&buffer, compositeKeyDec4, db2.data()));
     QVERIFY(reader.hasError());
 }
+
+void TestKeys::testCalibrateRounds()
+{
+    // Simulated derivation with a fixed setup cost of 40 ms and 20 us per round
+    const qint64 overheadNs = 40000000;
+    const qint64 costNs = 20000;
+    int calls = 0;
+    auto derive = [&](int rounds) {
+        ++calls;
+        QElapsedTimer timer;
+        timer.start();
+        while (timer.nsecsElapsed() < overheadNs + rounds * costNs) {
+        }
+        return true;
+    };
+
+    // (200 ms - 40 ms) / 20 us, extrapolating from one sample would give about 2000
+    int rounds = Kdf::calibrateRounds(200, 1, derive);
+    QVERIFY2(rounds > 6000 && rounds < 10000, qPrintable(QString::number(rounds)));
+    QVERIFY(calls > 2);
+
+    // Targets below the setup cost still yield the minimum
+    QCOMPARE(Kdf::calibrateRounds(20, 10, derive), 10);
+
+    // Failing derivations fall back to the minimum
+    calls = 0;
+    QCOMPARE(Kdf::calibrateRounds(200, 5, [&](int) { return ++calls == 1; }), 5);
+    QCOMPARE(calls, 2);
+    QCOMPARE(Kdf::calibrateRounds(200, 7, [](int) { return false; }), 7);
+}
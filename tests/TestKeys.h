@@ -33,8 +33,11 @@ private slots:
     void testCreateFileKey();
     void testCreateAndOpenFileKey();
     void testFileKeyHash();
+    void testFileKeyHashLarge();
+    void testFileKeyXmlEncodings();
     void testFileKeyError();
     void testCompositeKeyComponents();
+    void testCalibrateRounds();
     void benchmarkTransformKey();
 };
 
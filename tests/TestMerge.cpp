@@ -108,6 +108,43 @@ void TestMerge::testMergeNoChanges()
     QCOMPARE(dbSource->rootGroup()->entriesRecursive().size(), 2);
 }
 
+/**
+ * Merging a history that is already known should neither copy nor
+ * replace the history items of the destination entry.
+ */
+void TestMerge::testMergeHistoryKeepsItems()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+    Entry* destinationEntry = dbDestination->rootGroup()->findEntryByPath("entry1");
+    QVERIFY(destinationEntry != nullptr);
+    for (int i = 0; i < 5; ++i) {
+        m_clock->advanceSecond(1);
+        destinationEntry->beginUpdate();
+        destinationEntry->setNotes(QString("notes %1").arg(i));
+        destinationEntry->endUpdate();
+    }
+
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+    // Make the destination newer so its entry is kept and merged into
+    m_clock->advanceSecond(1);
+    destinationEntry->beginUpdate();
+    destinationEntry->setNotes("newest notes");
+    destinationEntry->endUpdate();
+
+    const auto historyItems = destinationEntry->historyItems();
+    QVERIFY(historyItems.size() >= 6);
+
+    m_clock->advanceSecond(1);
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.merge();
+
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry1"), destinationEntry);
+    QCOMPARE(destinationEntry->historyItems(), historyItems);
+    QCOMPARE(destinationEntry->notes(), QString("newest notes"));
+}
+
 /**
  * If the entry is updated in the source database, the update
  * should propagate in the destination database.
@@ -1385,6 +1422,56 @@ void TestMerge::testDeletedRevertedEntry()
     QVERIFY(entry2DestinationMerged->notes() == "Updated");
 }
 
+void TestMerge::testDeletedEntryTwice()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneNoFlags, Group::CloneIncludeEntries));
+
+    m_clock->advanceSecond(1);
+
+    QPointer<Entry> entry1SourceInitial = dbSource->rootGroup()->findEntryByPath("entry1");
+    QVERIFY(entry1SourceInitial != nullptr);
+    const QUuid entry1Uuid = entry1SourceInitial->uuid();
+    const QDateTime firstDeletionTime = m_clock->currentDateTimeUtc();
+    delete entry1SourceInitial;
+
+    m_clock->advanceSecond(1);
+
+    QPointer<Entry> entry1DestinationInitial = dbDestination->rootGroup()->findEntryByPath("entry1");
+    QVERIFY(entry1DestinationInitial != nullptr);
+    entry1DestinationInitial->setNotes("Updated");
+
+    m_clock->advanceSecond(1);
+
+    // The entry comes back to the source, e.g. from another replica, and is deleted again
+    auto* entry1SourceRestored = new Entry();
+    entry1SourceRestored->setUuid(entry1Uuid);
+    entry1SourceRestored->setGroup(dbSource->rootGroup());
+    delete entry1SourceRestored;
+
+    // A uuid is recorded once, with the earliest deletion time that merging uses anyway
+    int records = 0;
+    for (const auto& object : dbSource->deletedObjects()) {
+        if (object.uuid == entry1Uuid) {
+            QCOMPARE(object.deletionTime, firstDeletionTime);
+            ++records;
+        }
+    }
+    QCOMPARE(records, 1);
+
+    m_clock->advanceSecond(1);
+
+    dbDestination->rootGroup()->setMergeMode(Group::Synchronize);
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.merge();
+
+    // Changed after the first deletion, so the entry is kept just like with separate records per deletion
+    QPointer<Entry> entry1DestinationMerged = dbDestination->rootGroup()->findEntryByPath("entry1");
+    QVERIFY(entry1DestinationMerged);
+    QCOMPARE(entry1DestinationMerged->notes(), QString("Updated"));
+}
+
 void TestMerge::testDeletedRevertedGroup()
 {
     QScopedPointer<Database> dbDestination(createTestDatabase());
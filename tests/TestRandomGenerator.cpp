@@ -22,6 +22,7 @@
 #include "core/Global.h"
 #include "crypto/Random.h"
 
+#include <QSet>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestRandomGenerator)
@@ -60,3 +61,21 @@ void TestRandomGenerator::testUIntRange()
         QVERIFY(rand < 200);
     }
 }
+
+void TestRandomGenerator::testBuffered()
+{
+    // Small requests are served from a per-thread buffer, make sure
+    // consecutive draws across buffer refills never repeat
+    QSet<QByteArray> seen;
+    for (int i = 0; i < 1000; ++i) {
+        auto ba = randomGen()->randomArray(16);
+        QCOMPARE(ba.size(), 16);
+        QVERIFY(!seen.contains(ba));
+        seen.insert(ba);
+    }
+
+    // Large requests bypass the buffer
+    auto large = randomGen()->randomArray(8192);
+    QCOMPARE(large.size(), 8192);
+    QVERIFY(large != QByteArray(8192, '\0'));
+}
@@ -28,6 +28,7 @@ private slots:
     void testArray();
     void testUInt();
     void testUIntRange();
+    void testBuffered();
 };
 
 #endif // KEEPASSX_TESTRANDOMGENERATOR_H
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestScale.h"
+#include "TestGlobal.h"
+
+#include "core/DatabaseStatistics.h"
+#include "core/EntrySearcher.h"
+#include "core/Merger.h"
+#include "crypto/Crypto.h"
+#include "crypto/kdf/Kdf.h"
+#include "format/KeePass2.h"
+#include "format/KeePass2Reader.h"
+#include "format/KeePass2Writer.h"
+#include "gui/entry/EntryModel.h"
+#include "keys/PasswordKey.h"
+#include "util/DatabaseGenerator.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+
+#include <functional>
+#include <limits>
+
+QTEST_GUILESS_MAIN(TestScale)
+
+namespace
+{
+    // Sizes of the small and the large run
+    constexpr int SmallSize = 2500;
+    constexpr int LargeSize = 4 * SmallSize;
+    // Linear growth gives a factor of 4 between the runs, quadratic growth 16
+    constexpr int MaxGrowth = 8;
+    // Absorbs timer resolution and scheduling noise of short runs
+    constexpr qint64 SlackNs = 20 * 1000 * 1000;
+    // Each measurement is the fastest of several runs
+    constexpr int Runs = 3;
+
+    DatabaseGenerator::Options options(int entries)
+    {
+        DatabaseGenerator::Options options;
+        options.seed = 2021;
+        options.entries = entries;
+        options.groups = entries / 20;
+        options.depth = 4;
+        options.historyItems = 2;
+        options.referencePercent = 10;
+        options.totpPercent = 5;
+        return options;
+    }
+
+    /**
+     * Time the fastest of several runs of an operation.
+     * The setup runs before each repetition and is not timed.
+     */
+    qint64 fastest(const std::function<void()>& setup, const std::function<void()>& operation)
+    {
+        qint64 result = std::numeric_limits<qint64>::max();
+        for (int i = 0; i < Runs; ++i) {
+            setup();
+            QElapsedTimer timer;
+            timer.start();
+            operation();
+            result = qMin(result, timer.nsecsElapsed());
+        }
+        return result;
+    }
+
+    void verifyLinear(const char* operation, const std::function<qint64(int)>& measure)
+    {
+        const qint64 small = measure(SmallSize);
+        const qint64 large = measure(LargeSize);
+        QVERIFY2(large <= MaxGrowth * small + SlackNs,
+                 qPrintable(QString("%1 does not scale linearly: %2 ms for %3 entries, %4 ms for %5 entries")
+                                .arg(operation)
+                                .arg(small / 1000000.0)
+                                .arg(SmallSize)
+                                .arg(large / 1000000.0)
+                                .arg(LargeSize)));
+    }
+
+    QSharedPointer<Kdf> fastKdf()
+    {
+        auto kdf = KeePass2::uuidToKdf(KeePass2::KDF_AES_KDBX4);
+        kdf->setRounds(1);
+        return kdf;
+    }
+} // namespace
+
+void TestScale::initTestCase()
+{
+    QVERIFY(Crypto::init());
+}
+
+void TestScale::testMerge()
+{
+    verifyLinear("Merge", [](int size) {
+        QSharedPointer<Database> source;
+        QSharedPointer<Database> target;
+        return fastest(
+            [&]() {
+                source = DatabaseGenerator(options(size)).generate();
+                target = QSharedPointer<Database>::create();
+                target->setRootGroup(
+                    source->rootGroup()->clone(Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+                // Change every tenth entry in the source, the merge has to update them in the target
+                const auto entries = source->rootGroup()->entriesRecursive();
+                for (int i = 0; i < entries.size(); i += 10) {
+                    entries[i]->setNotes(QString("changed %1").arg(i));
+                }
+            },
+            [&]() {
+                Merger merger(source.data(), target.data());
+                merger.merge();
+            });
+    });
+}
+
+void TestScale::testSearch()
+{
+    verifyLinear("Search", [](int size) {
+        auto db = DatabaseGenerator(options(size)).generate();
+        EntrySearcher searcher;
+        return fastest([]() {},
+                       [&]() {
+                           searcher.search("alpha", db->rootGroup(), true);
+                           searcher.search("user:bravo url:example", db->rootGroup(), true);
+                           searcher.search("-charlie *lta", db->rootGroup(), true);
+                       });
+    });
+}
+
+void TestScale::testSaveLoad()
+{
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("scale"));
+
+    verifyLinear("Save and load", [&](int size) {
+        auto db = DatabaseGenerator(options(size)).generate();
+        db->changeKdf(fastKdf());
+        db->setKey(key);
+
+        return fastest([]() {},
+                       [&]() {
+                           QBuffer buffer;
+                           buffer.open(QBuffer::ReadWrite);
+                           KeePass2Writer writer;
+                           QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+                           buffer.seek(0);
+                           Database loaded;
+                           KeePass2Reader reader;
+                           QVERIFY(reader.readDatabase(&buffer, key, &loaded));
+                           QCOMPARE(loaded.rootGroup()->entriesRecursive().size(), size);
+                       });
+    });
+}
+
+void TestScale::testReferenceResolution()
+{
+    verifyLinear("Reference resolution", [](int size) {
+        auto generatorOptions = options(size);
+        generatorOptions.referencePercent = 50;
+        auto db = DatabaseGenerator(generatorOptions).generate();
+        const auto entries = db->rootGroup()->entriesRecursive();
+
+        return fastest([]() {},
+                       [&]() {
+                           for (const auto* entry : entries) {
+                               entry->resolveMultiplePlaceholders(entry->username());
+                               entry->resolveMultiplePlaceholders(entry->password());
+                           }
+                       });
+    });
+}
+
+void TestScale::testEntryModel()
+{
+    verifyLinear("Entry model population", [](int size) {
+        auto generatorOptions = options(size);
+        generatorOptions.groups = 0;
+        auto db = DatabaseGenerator(generatorOptions).generate();
+        QScopedPointer<EntryModel> model;
+
+        return fastest([&]() { model.reset(new EntryModel()); },
+                       [&]() {
+                           model->setGroup(db->rootGroup());
+                           for (int row = 0; row < model->rowCount(); ++row) {
+                               for (int column = 0; column < model->columnCount(); ++column) {
+                                   model->data(model->index(row, column), Qt::DisplayRole);
+                               }
+                           }
+                       });
+    });
+}
+
+void TestScale::testMemoryUsage()
+{
+    auto db = DatabaseGenerator(options(LargeSize)).generate();
+    const auto usage = db->statistics()->memoryUsage();
+
+    // Generous upper bounds, an entry with two history items takes a few KiB
+    QVERIFY(usage.entries < LargeSize * qint64(8 * 1024));
+    QVERIFY(usage.history < LargeSize * qint64(16 * 1024));
+    QVERIFY(usage.total() < LargeSize * qint64(32 * 1024));
+}
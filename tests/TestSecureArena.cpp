@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestSecureArena.h"
+
+#include "core/SecureArena.h"
+#include "crypto/Crypto.h"
+
+#include <QTest>
+
+#include <cstring>
+
+QTEST_GUILESS_MAIN(TestSecureArena)
+
+namespace
+{
+    bool isZero(const char* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (data[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+void TestSecureArena::initTestCase()
+{
+    QVERIFY(Crypto::init());
+}
+
+void TestSecureArena::testSmallAllocation()
+{
+    const std::size_t mapped = SecureArena::mappedBytes();
+
+    // Small allocations come zeroed from the locked pool and do not get their own mapping
+    auto* data = static_cast<char*>(SecureArena::allocate(32));
+    QVERIFY(data);
+    QVERIFY(isZero(data, 32));
+    QCOMPARE(SecureArena::mappedBytes(), mapped);
+    std::memset(data, 0x5A, 32);
+    SecureArena::deallocate(data, 32);
+
+    // Empty requests still return a usable pointer
+    void* empty = SecureArena::allocate(0);
+    QVERIFY(empty);
+    SecureArena::deallocate(empty, 0);
+    SecureArena::deallocate(nullptr, 16);
+
+    SecureVector<char> key(20, 'k');
+    QCOMPARE(key.size(), std::size_t(20));
+    QCOMPARE(key.back(), 'k');
+}
+
+void TestSecureArena::testMappedAllocation()
+{
+#if defined(Q_OS_UNIX) || defined(Q_OS_WIN)
+    const std::size_t mapped = SecureArena::mappedBytes();
+
+    // Large allocations are rounded up to whole pages of their own
+    const std::size_t size = 3 * 4096 + 1;
+    auto* data = static_cast<char*>(SecureArena::allocate(size));
+    QVERIFY(data);
+    const std::size_t added = SecureArena::mappedBytes() - mapped;
+    QVERIFY(added >= size);
+    QVERIFY(isZero(data, size));
+
+    // The whole requested range is writable
+    std::memset(data, 0x5A, size);
+    QCOMPARE(data[size - 1], char(0x5A));
+
+    SecureArena::deallocate(data, size);
+    QCOMPARE(SecureArena::mappedBytes(), mapped);
+#else
+    QSKIP("Guard-paged mappings are not supported on this platform");
+#endif
+}
+
+void TestSecureArena::testScrubOnRelease()
+{
+    char buffer[64];
+    std::memset(buffer, 0x5A, sizeof(buffer));
+    SecureArena::scrub(buffer, sizeof(buffer));
+    QVERIFY(isZero(buffer, sizeof(buffer)));
+
+    // Every released byte goes through the scrub, whichever way it was allocated
+    for (std::size_t size : {std::size_t(48), std::size_t(5 * 4096)}) {
+        const std::size_t scrubbed = SecureArena::scrubbedBytes();
+        auto* data = static_cast<char*>(SecureArena::allocate(size));
+        std::memset(data, 0x5A, size);
+        SecureArena::deallocate(data, size);
+        QVERIFY(SecureArena::scrubbedBytes() - scrubbed >= size);
+    }
+}
+
+void TestSecureArena::testExhaustion()
+{
+    const std::size_t mapped = SecureArena::mappedBytes();
+
+    // A request that cannot be mapped fails like operator new
+    QVERIFY_EXCEPTION_THROWN(SecureArena::allocate(std::numeric_limits<std::size_t>::max() / 2), std::bad_alloc);
+    QCOMPARE(SecureArena::mappedBytes(), mapped);
+
+    // The element count is checked before it is turned into a byte count
+    SecureAllocator<quint64> allocator;
+    QVERIFY_EXCEPTION_THROWN(allocator.allocate(std::numeric_limits<std::size_t>::max() / 4), std::bad_alloc);
+}
@@ -18,7 +18,9 @@
 #include "TestTools.h"
 
 #include <QLocale>
+#include <QRegularExpression>
 #include <QTest>
+#include <QtConcurrent>
 
 QTEST_GUILESS_MAIN(TestTools)
 
@@ -89,3 +91,38 @@ void TestTools::testEnvSubstitute()
     QCOMPARE(Tools::envSubstitute("start/$EMPTY$$EMPTY$HOME/end", environment), QString("start/$/home/user/end"));
 #endif
 }
+
+void TestTools::testConvertToRegex()
+{
+    QVERIFY(QString("Hello World").contains(Tools::convertToRegex("hello")));
+    QVERIFY(!QString("Hello World").contains(Tools::convertToRegex("hello", false, false, true)));
+    QVERIFY(QString("Hello World").contains(Tools::convertToRegex("h*o w?rld", true)));
+    QVERIFY(!QString("Hello World").contains(Tools::convertToRegex("h*o w?rld")));
+    QVERIFY(QString("a.b").contains(Tools::convertToRegex("a.b", true)));
+    QVERIFY(!QString("axb").contains(Tools::convertToRegex("a.b", true)));
+    QVERIFY(!QString("Hello World").contains(Tools::convertToRegex("hello", false, true)));
+    QVERIFY(QString("foo").contains(Tools::convertToRegex("bar|foo", true, true)));
+
+    // Cached expressions are returned for equal arguments only. A copy of the
+    // cached expression shares its data, which is the only member of QRegularExpression.
+    static_assert(sizeof(QRegularExpression) == sizeof(void*), "QRegularExpression is a single d-pointer");
+    auto sharedData = [](const QRegularExpression& regex) { return *reinterpret_cast<void* const*>(&regex); };
+    const auto cached = Tools::convertToRegex("a*b", true);
+    QCOMPARE(sharedData(Tools::convertToRegex("a*b", true)), sharedData(cached));
+    QVERIFY(sharedData(Tools::convertToRegex("a*b", false)) != sharedData(cached));
+    QVERIFY(sharedData(QRegularExpression(cached.pattern(), cached.patternOptions())) != sharedData(cached));
+    QCOMPARE(Tools::convertToRegex("a*b", true), cached);
+    QVERIFY(Tools::convertToRegex("a*b", true) != Tools::convertToRegex("a*b", false));
+    QVERIFY(Tools::convertToRegex("a*b", true).isValid());
+
+    // Concurrent lookups and insertions, more patterns than fit in the cache
+    QList<int> numbers;
+    for (int i = 0; i < 2000; ++i) {
+        numbers << i;
+    }
+    const auto results = QtConcurrent::blockingMapped<QList<bool>>(numbers, [](int i) {
+        const auto text = QString("item%1").arg(i % 700);
+        return text.contains(Tools::convertToRegex(QString("ITEM%1").arg(i % 700), true, true));
+    });
+    QVERIFY(!results.contains(false));
+}
@@ -622,8 +622,6 @@ void TestGui::testAddEntry()
     QCOMPARE(entry->username(), QString("AutocompletionUsername"));
     QCOMPARE(entry->historyItems().size(), 0);
 
-    m_db->updateCommonUsernames();
-
     // Add entry "something 2"
     QTest::mouseClick(entryNewWidget, Qt::LeftButton);
     QTest::keyClicks(titleEdit, "something 2");
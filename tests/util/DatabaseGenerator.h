@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASEGENERATOR_H
+#define KEEPASSXC_DATABASEGENERATOR_H
+
+#include <QDateTime>
+#include <QList>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QUuid>
+
+#include <random>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Builds synthetic databases of realistic size for scale tests and profiling.
+ * The same options and seed always produce the same database content,
+ * including uuids and timestamps.
+ */
+class DatabaseGenerator
+{
+public:
+    struct Options
+    {
+        quint32 seed = 1;
+        int groups = 10;
+        int entries = 100;
+        int depth = 3; // Maximum nesting depth of groups below the root group
+        int historyItems = 0; // History items per entry
+        int attachmentPercent = 0; // Share of entries with an attachment
+        int attachmentSize = 4096; // Mean attachment size in bytes, sizes are exponentially distributed
+        int customIcons = 0;
+        int referencePercent = 0; // Share of entries referencing username and password of another entry
+        int totpPercent = 0;
+        int sshKeyPercent = 0; // Share of entries with KeeAgent settings and a key attachment
+        int passwordReusePercent = 10;
+    };
+
+    explicit DatabaseGenerator(const Options& options);
+
+    QSharedPointer<Database> generate();
+    void populate(Database* db);
+
+private:
+    quint32 next();
+    int bounded(int max);
+    bool chance(int percent);
+    QUuid uuid();
+    QByteArray bytes(int size);
+    QString word();
+    QString words(int count, const QString& separator);
+    QString password();
+    QDateTime timestamp();
+
+    void addCustomIcons(Database* db);
+    void addGroups(Group* root);
+    void addEntry(Group* group);
+    QDateTime addHistory(Entry* entry);
+
+    Options m_options;
+    std::mt19937 m_random;
+    QDateTime m_epoch;
+    QList<QUuid> m_icons;
+    QList<Group*> m_groups;
+    QList<int> m_depths;
+    QList<Entry*> m_entries;
+    QStringList m_passwords;
+};
+
+#endif // KEEPASSXC_DATABASEGENERATOR_H